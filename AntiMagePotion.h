@@ -28,8 +28,8 @@ public:
 		SpriteSheet(8)
 	{
 		this->resetSpriteSheet();
-		sf::IntRect size = this->spritePtr()->getTextureRect();
-		this->spritePtr()->setOrigin(static_cast<float>(size.width / 2), static_cast<float>(size.height / 2));
+		sf::IntRect size = this->getSprite()->getTextureRect();
+		this->getSprite()->setOrigin(static_cast<float>(size.width / 2), static_cast<float>(size.height / 2));
 	}
 
 	void EveryFrame(uint64_t f)
@@ -37,18 +37,13 @@ public:
 		if (f % 10 == 0) { this->spriteSheetRow++; }
 		if (this->currentRotation >= this->wiggleMagnitude || this->currentRotation <= (-1.f * this->wiggleMagnitude)) { this->wiggleDirection *= -1; }
 		this->currentRotation += static_cast<float>(this->wiggleDirection) * this->wiggleSpeed;
-		this->spritePtr()->setRotation(this->currentRotation);
+		this->getSprite()->setRotation(this->currentRotation);
 	}
 
 	void die()
 	{
 		this->screen->remove(this);
 	}
-
-	sf::Sprite* spritePtr()
-	{
-		return dynamic_cast<sf::Sprite*>(this->graphic);
-	}
 };
 
 #endif
@@ -0,0 +1,241 @@
+#ifndef ASSET_ARCHIVE_H
+#define ASSET_ARCHIVE_H
+
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Engine
+{
+	//the files of data/ packed into one file, built by tools/AssetPacker
+	//once the archive is mounted every resource is read straight out of one memory mapping, so loading a file needs no open or read call
+	//layout: header | index entries sorted by name | names | file contents, every file starting on a 16 byte boundary
+	//all values are little endian
+	class AssetArchive
+	{
+	public:
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t entryCount;
+			uint32_t namesOffset;
+			uint64_t fileSize;
+		};
+
+		//files are stored as they are, the compression field leaves room for a compressed format without changing the index
+		enum Compression : uint32_t { Stored = 0 };
+
+		struct Entry
+		{
+			uint64_t offset;
+			uint64_t size;
+			uint32_t nameOffset;
+			uint32_t nameLength;
+			uint32_t compression;
+			uint32_t reserved;
+		};
+
+		static constexpr uint32_t currentVersion = 1;
+		static constexpr uint64_t alignment = 16;
+
+		//builds the archive image of the given files, names are relative to data/ and use forward slashes
+		static std::vector<uint8_t> encode(std::vector<std::pair<std::string, std::vector<uint8_t>>> files)
+		{
+			std::sort(files.begin(), files.end(), [](auto const & a, auto const & b) { return a.first < b.first; });
+			Header header;
+			std::memcpy(header.magic, "CZPK", 4);
+			header.version = currentVersion;
+			header.entryCount = static_cast<uint32_t>(files.size());
+			header.namesOffset = static_cast<uint32_t>(sizeof(Header) + files.size() * sizeof(Entry));
+
+			std::vector<Entry> entries(files.size());
+			std::string names;
+			for (size_t i = 0; i < files.size(); i++)
+			{
+				entries[i].nameOffset = static_cast<uint32_t>(names.size());
+				entries[i].nameLength = static_cast<uint32_t>(files[i].first.size());
+				entries[i].compression = Stored;
+				entries[i].reserved = 0;
+				names += files[i].first;
+			}
+			uint64_t offset = alignUp(header.namesOffset + names.size());
+			for (size_t i = 0; i < files.size(); i++)
+			{
+				entries[i].offset = offset;
+				entries[i].size = files[i].second.size();
+				offset = alignUp(offset + entries[i].size);
+			}
+			header.fileSize = offset;
+
+			std::vector<uint8_t> image(static_cast<size_t>(offset), 0);
+			std::memcpy(image.data(), &header, sizeof(Header));
+			if (!entries.empty()) { std::memcpy(image.data() + sizeof(Header), entries.data(), entries.size() * sizeof(Entry)); }
+			std::memcpy(image.data() + header.namesOffset, names.data(), names.size());
+			for (size_t i = 0; i < files.size(); i++)
+			{
+				if (!files[i].second.empty()) { std::memcpy(image.data() + entries[i].offset, files[i].second.data(), files[i].second.size()); }
+			}
+			return image;
+		}
+
+		//checks the header and every index entry, the archive is used in place and data must outlive it
+		bool view(const uint8_t* data, size_t size)
+		{
+			this->image = nullptr;
+			if (size < sizeof(Header) || std::memcmp(data, "CZPK", 4) != 0) { return false; }
+			std::memcpy(&this->header, data, sizeof(Header));
+			const Header& h = this->header;
+			if (h.version != currentVersion || h.fileSize > size || h.namesOffset < sizeof(Header)
+				|| sizeof(Header) + static_cast<uint64_t>(h.entryCount) * sizeof(Entry) > h.namesOffset)
+			{
+				return false;
+			}
+			std::string previous;
+			for (uint32_t i = 0; i < h.entryCount; i++)
+			{
+				Entry entry = this->entryAt(data, i);
+				if (entry.compression != Stored || entry.offset > h.fileSize || entry.size > h.fileSize - entry.offset
+					|| static_cast<uint64_t>(h.namesOffset) + entry.nameOffset + entry.nameLength > h.fileSize)
+				{
+					return false;
+				}
+				//the lookup is a binary search, so the names must be in order
+				std::string name(reinterpret_cast<const char*>(data) + h.namesOffset + entry.nameOffset, entry.nameLength);
+				if (i > 0 && !(previous < name)) { return false; }
+				previous = std::move(name);
+			}
+			this->image = data;
+			return true;
+		}
+
+		bool isValid() const { return this->image != nullptr; }
+		uint32_t size() const { return (this->image) ? this->header.entryCount : 0; }
+
+		std::string name(uint32_t index) const
+		{
+			Entry entry = this->entryAt(this->image, index);
+			return std::string(reinterpret_cast<const char*>(this->image) + this->header.namesOffset + entry.nameOffset, entry.nameLength);
+		}
+
+		//points data at the file's contents inside the archive, returns false if the archive has no such file
+		bool find(const std::string& filename, const uint8_t*& data, size_t& size) const
+		{
+			if (this->image == nullptr) { return false; }
+			uint32_t low = 0;
+			uint32_t high = this->header.entryCount;
+			while (low < high)
+			{
+				uint32_t middle = low + (high - low) / 2;
+				Entry entry = this->entryAt(this->image, middle);
+				int order = compareName(reinterpret_cast<const char*>(this->image) + this->header.namesOffset + entry.nameOffset, entry.nameLength, filename);
+				if (order == 0)
+				{
+					data = this->image + entry.offset;
+					size = static_cast<size_t>(entry.size);
+					return true;
+				}
+				if (order < 0) { low = middle + 1; }
+				else { high = middle; }
+			}
+			return false;
+		}
+
+		//maps the archive that resources are loaded from, returns false and leaves the loose files in use if it cannot be read
+		//mount before the first resource is loaded, the loader threads read the mounted archive without locking
+		//fonts and music keep reading from the mapping while they play, so it stays mapped until unmount, which is only safe once none are left
+		static bool mount(const std::string& path)
+		{
+			AssetArchive& archive = getMounted();
+			MappedFile& file = getMountedFile();
+			archive = AssetArchive();
+			if (!file.open(path)) { return false; }
+			if (!archive.view(file.data(), file.size()))
+			{
+				file.close();
+				return false;
+			}
+			return true;
+		}
+
+		static void unmount()
+		{
+			getMounted() = AssetArchive();
+			getMountedFile().close();
+		}
+
+		static const AssetArchive& getMountedArchive()
+		{
+			return getMounted();
+		}
+
+		//looks a file up in the mounted archive, filename is relative to data/
+		static bool findMounted(const std::string& filename, const uint8_t*& data, size_t& size)
+		{
+			return getMounted().find(filename, data, size);
+		}
+
+		//loads a resource from the mounted archive with loadFromMemory, or from data/ with loadFromFile if the archive does not have the file
+		template<typename T> static bool loadResource(const std::string& filename, T& resource)
+		{
+			const uint8_t* data;
+			size_t size;
+			if (findMounted(filename, data, size)) { return resource.loadFromMemory(data, size); }
+			return resource.loadFromFile(std::string("data/") + filename);
+		}
+
+		//size of the file in the mounted archive or in data/, 0 if neither has it
+		static uint64_t fileSize(const std::string& filename)
+		{
+			const uint8_t* data;
+			size_t size;
+			if (findMounted(filename, data, size)) { return size; }
+			std::ifstream fin((std::string("data/") + filename).c_str(), std::ios::binary | std::ios::ate);
+			std::streamoff length = fin ? static_cast<std::streamoff>(fin.tellg()) : 0;
+			return (length > 0) ? static_cast<uint64_t>(length) : 0;
+		}
+
+	private:
+		static AssetArchive& getMounted()
+		{
+			static AssetArchive archive;
+			return archive;
+		}
+
+		static MappedFile& getMountedFile()
+		{
+			static MappedFile file;
+			return file;
+		}
+
+		static uint64_t alignUp(uint64_t offset)
+		{
+			return (offset + alignment - 1) / alignment * alignment;
+		}
+
+		static int compareName(const char* name, uint32_t length, const std::string& filename)
+		{
+			int order = std::memcmp(name, filename.data(), std::min<size_t>(length, filename.size()));
+			if (order != 0) { return order; }
+			if (length == filename.size()) { return 0; }
+			return (length < filename.size()) ? -1 : 1;
+		}
+
+		Entry entryAt(const uint8_t* data, uint32_t index) const
+		{
+			Entry entry;
+			std::memcpy(&entry, data + sizeof(Header) + static_cast<size_t>(index) * sizeof(Entry), sizeof(Entry));
+			return entry;
+		}
+
+		Header header = Header();
+		const uint8_t* image = nullptr;
+	};
+}
+
+#endif
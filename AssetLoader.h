@@ -0,0 +1,171 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine
+{
+	//worker threads that read and decode asset files off the main thread
+	//each job has a decode step run by a worker and a finish step, like a texture upload, run on the main thread by finishLoads or wait
+	//Screen calls finishLoads once per frame, so finished jobs never stall a frame on disk or decode
+	class AssetLoader
+	{
+	public:
+		class Job
+		{
+		private:
+			friend class AssetLoader;
+			enum class State { Queued, Decoding, Decoded };
+			std::function<void()> decode;
+			std::function<void()> finish;
+			State state = State::Queued;
+			bool finished = false; //only touched on the main thread
+		};
+		typedef std::shared_ptr<Job> Ticket;
+
+		AssetLoader() = delete;
+
+		static Ticket submit(std::function<void()> decode, std::function<void()> finish)
+		{
+			Pool& pool = getPool();
+			Ticket job = std::make_shared<Job>();
+			job->decode = std::move(decode);
+			job->finish = std::move(finish);
+			{
+				std::lock_guard<std::mutex> lock(pool.mutex);
+				pool.start();
+				pool.queued.push_back(job);
+			}
+			pool.workReady.notify_one();
+			return job;
+		}
+
+		//blocks until the job is decoded and runs its finish step now, a job no worker has picked up yet is decoded on this thread instead of waiting its turn
+		static void wait(const Ticket& job)
+		{
+			if (job == nullptr || job->finished) { return; }
+			Pool& pool = getPool();
+			std::unique_lock<std::mutex> lock(pool.mutex);
+			if (job->state == Job::State::Queued)
+			{
+				job->state = Job::State::Decoding;
+				lock.unlock();
+				job->decode();
+				lock.lock();
+				job->state = Job::State::Decoded;
+			}
+			else
+			{
+				pool.jobDecoded.wait(lock, [&]() { return job->state == Job::State::Decoded; });
+				auto iter = std::find(pool.decoded.begin(), pool.decoded.end(), job);
+				if (iter != pool.decoded.end()) { pool.decoded.erase(iter); }
+			}
+			lock.unlock();
+			runFinish(*job);
+		}
+
+		//runs the finish step of every job decoded so far, returns how many there were
+		static size_t finishLoads()
+		{
+			Pool& pool = getPool();
+			{
+				std::lock_guard<std::mutex> lock(pool.mutex);
+				if (pool.decoded.empty()) { return 0; }
+				pool.finishing.swap(pool.decoded);
+			}
+			size_t count = pool.finishing.size();
+			for (auto const & job : pool.finishing) { runFinish(*job); }
+			pool.finishing.clear();
+			return count;
+		}
+
+		static bool isDecoded(const Ticket& job)
+		{
+			if (job == nullptr) { return true; }
+			std::lock_guard<std::mutex> lock(getPool().mutex);
+			return job->state == Job::State::Decoded;
+		}
+
+		static unsigned int getWorkerCount()
+		{
+			//one core is left for the main thread
+			unsigned int cores = std::thread::hardware_concurrency();
+			return std::max(1U, std::min(4U, (cores > 1U) ? cores - 1U : 1U));
+		}
+
+	private:
+		struct Pool
+		{
+			std::mutex mutex;
+			std::condition_variable workReady;
+			std::condition_variable jobDecoded;
+			std::deque<Ticket> queued;
+			std::vector<Ticket> decoded; //waiting for their finish step
+			std::vector<Ticket> finishing; //main thread only, swapped with decoded so finish steps run without the lock
+			std::vector<std::thread> workers;
+			bool stopping = false;
+
+			//workers are started by the first job, called with the mutex held
+			void start()
+			{
+				if (!this->workers.empty()) { return; }
+				for (unsigned int i = 0; i < getWorkerCount(); i++) { this->workers.emplace_back([this]() { this->work(); }); }
+			}
+
+			void work()
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+				while (true)
+				{
+					this->workReady.wait(lock, [this]() { return this->stopping || !this->queued.empty(); });
+					if (this->stopping) { return; }
+					Ticket job = std::move(this->queued.front());
+					this->queued.pop_front();
+					//the main thread may have taken the job while it waited in the queue
+					if (job->state != Job::State::Queued) { continue; }
+					job->state = Job::State::Decoding;
+					lock.unlock();
+					job->decode();
+					lock.lock();
+					job->state = Job::State::Decoded;
+					this->decoded.push_back(job);
+					this->jobDecoded.notify_all();
+				}
+			}
+
+			~Pool()
+			{
+				{
+					std::lock_guard<std::mutex> lock(this->mutex);
+					this->stopping = true;
+				}
+				this->workReady.notify_all();
+				for (auto& worker : this->workers) { worker.join(); }
+			}
+		};
+
+		static void runFinish(Job& job)
+		{
+			if (job.finished) { return; }
+			job.finished = true;
+			job.finish();
+			job.decode = nullptr;
+			job.finish = nullptr;
+		}
+
+		static Pool& getPool()
+		{
+			static Pool pool;
+			return pool;
+		}
+	};
+}
+
+#endif
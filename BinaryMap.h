@@ -0,0 +1,203 @@
+#ifndef BINARY_MAP_H
+#define BINARY_MAP_H
+
+#include "TileProperties.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Engine
+{
+	//compact tile map format that is used in place once the file is memory mapped
+	//layout: header | tiles, 1 or 2 bytes each, row by row | TileProperties flags, 1 byte per tile | safe spawn positions as x, y float pairs
+	//every section starts on a 4 byte boundary, all values are little endian
+	class BinaryMap
+	{
+	public:
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t width;
+			uint32_t height;
+			uint32_t tileWidth;
+			uint32_t tileHeight;
+			uint32_t bytesPerTile;
+			uint32_t spawnCount;
+			uint32_t tilesOffset;
+			uint32_t flagsOffset;
+			uint32_t spawnsOffset;
+			uint32_t fileSize;
+		};
+
+		static constexpr uint32_t currentVersion = 2;
+
+		static bool isBinary(const uint8_t* data, size_t size)
+		{
+			return size >= sizeof(Header) && std::memcmp(data, "CZMP", 4) == 0;
+		}
+
+		//builds the binary image of a map, returns an empty vector if a tile does not fit in 16 bits
+		//each cell's flags come from the tile properties, except the first row and column, which count as out of bounds like getTileAt reports them
+		static std::vector<uint8_t> encode(uint32_t width, uint32_t height, uint32_t tileWidth, uint32_t tileHeight, const std::vector<int>& tiles, const TileProperties& properties)
+		{
+			size_t count = static_cast<size_t>(width) * static_cast<size_t>(height);
+			if (tiles.size() != count) { return {}; }
+			int maxTile = 0;
+			for (int tile : tiles)
+			{
+				if (tile < 0 || tile > 0xFFFF) { return {}; }
+				if (tile > maxTile) { maxTile = tile; }
+			}
+
+			std::vector<uint8_t> flags(count);
+			for (uint32_t j = 0; j < height; j++)
+			{
+				for (uint32_t i = 0; i < width; i++)
+				{
+					size_t index = i + static_cast<size_t>(j) * width;
+					flags[index] = properties.flagsFor((i < 1 || j < 1) ? -1 : tiles[index]);
+				}
+			}
+
+			std::vector<float> spawns;
+			for (uint32_t i = 1; i + 1 < width; i++)
+			{
+				for (uint32_t j = 1; j + 1 < height; j++)
+				{
+					bool anyObstacles = false;
+					for (uint32_t nj = j - 1; nj <= j + 1; nj++)
+					{
+						for (uint32_t ni = i - 1; ni <= i + 1; ni++)
+						{
+							if ((ni != i || nj != j) && (flags[ni + static_cast<size_t>(nj) * width] & TileProperties::Obstacle)) { anyObstacles = true; }
+						}
+					}
+					if (!anyObstacles)
+					{
+						flags[i + static_cast<size_t>(j) * width] |= TileProperties::Spawnable;
+						spawns.push_back(static_cast<float>(tileWidth * i));
+						spawns.push_back(static_cast<float>(tileHeight * j));
+					}
+				}
+			}
+
+			Header header;
+			std::memcpy(header.magic, "CZMP", 4);
+			header.version = currentVersion;
+			header.width = width;
+			header.height = height;
+			header.tileWidth = tileWidth;
+			header.tileHeight = tileHeight;
+			header.bytesPerTile = (maxTile > 0xFF) ? 2 : 1;
+			header.spawnCount = static_cast<uint32_t>(spawns.size() / 2);
+			header.tilesOffset = static_cast<uint32_t>(align(sizeof(Header)));
+			header.flagsOffset = static_cast<uint32_t>(align(header.tilesOffset + count * header.bytesPerTile));
+			header.spawnsOffset = static_cast<uint32_t>(align(header.flagsOffset + count));
+			header.fileSize = static_cast<uint32_t>(header.spawnsOffset + spawns.size() * sizeof(float));
+
+			std::vector<uint8_t> out(header.fileSize, 0);
+			std::memcpy(out.data(), &header, sizeof(Header));
+			for (size_t index = 0; index < count; index++)
+			{
+				uint16_t tile = static_cast<uint16_t>(tiles[index]);
+				out[header.tilesOffset + index * header.bytesPerTile] = static_cast<uint8_t>(tile & 0xFF);
+				if (header.bytesPerTile == 2) { out[header.tilesOffset + index * 2 + 1] = static_cast<uint8_t>(tile >> 8); }
+			}
+			std::memcpy(out.data() + header.flagsOffset, flags.data(), count);
+			if (!spawns.empty()) { std::memcpy(out.data() + header.spawnsOffset, spawns.data(), spawns.size() * sizeof(float)); }
+			return out;
+		}
+
+		//parses the text format: width, height, tile width, tile height, then every tile row by row
+		static std::vector<uint8_t> encodeText(const char* text, size_t length, const TileProperties& properties)
+		{
+			const char* pos = text;
+			const char* end = text + length;
+			long values[4];
+			for (long& value : values)
+			{
+				if (!readInteger(pos, end, value) || value <= 0) { return {}; }
+			}
+			std::vector<int> tiles(static_cast<size_t>(values[0]) * static_cast<size_t>(values[1]));
+			for (int& tile : tiles)
+			{
+				long value;
+				if (!readInteger(pos, end, value)) { return {}; }
+				tile = static_cast<int>(value);
+			}
+			return encode(static_cast<uint32_t>(values[0]), static_cast<uint32_t>(values[1]), static_cast<uint32_t>(values[2]), static_cast<uint32_t>(values[3]), tiles, properties);
+		}
+
+		//points the map at a binary image without copying it, the image must outlive the map
+		bool view(const uint8_t* data, size_t size)
+		{
+			this->image = nullptr;
+			if (!isBinary(data, size)) { return false; }
+			std::memcpy(&this->header, data, sizeof(Header));
+			const Header& h = this->header;
+			size_t count = static_cast<size_t>(h.width) * static_cast<size_t>(h.height);
+			if (h.version != currentVersion || h.fileSize > size || (h.bytesPerTile != 1 && h.bytesPerTile != 2)
+				|| h.tilesOffset + count * h.bytesPerTile > h.fileSize
+				|| h.flagsOffset + count > h.fileSize
+				|| h.spawnsOffset + static_cast<size_t>(h.spawnCount) * 2 * sizeof(float) > h.fileSize)
+			{
+				return false;
+			}
+			this->image = data;
+			return true;
+		}
+
+		bool isValid() const { return this->image != nullptr; }
+		uint32_t width() const { return this->header.width; }
+		uint32_t height() const { return this->header.height; }
+		uint32_t tileWidth() const { return this->header.tileWidth; }
+		uint32_t tileHeight() const { return this->header.tileHeight; }
+		uint32_t spawnCount() const { return this->header.spawnCount; }
+
+		//index is column + row * width
+		int tile(size_t index) const
+		{
+			const uint8_t* tiles = this->image + this->header.tilesOffset;
+			if (this->header.bytesPerTile == 1) { return tiles[index]; }
+			return tiles[index * 2] | (tiles[index * 2 + 1] << 8);
+		}
+
+		//TileProperties flags of every cell, row by row
+		const uint8_t* flags() const
+		{
+			return this->image + this->header.flagsOffset;
+		}
+
+		void getSpawn(uint32_t index, float& x, float& y) const
+		{
+			const uint8_t* spawn = this->image + this->header.spawnsOffset + static_cast<size_t>(index) * 2 * sizeof(float);
+			std::memcpy(&x, spawn, sizeof(float));
+			std::memcpy(&y, spawn + sizeof(float), sizeof(float));
+		}
+
+	private:
+		static size_t align(size_t offset)
+		{
+			return (offset + 3) & ~static_cast<size_t>(3);
+		}
+
+		static bool readInteger(const char*& pos, const char* end, long& value)
+		{
+			while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n')) { pos++; }
+			bool negative = (pos < end && *pos == '-');
+			if (negative) { pos++; }
+			if (pos >= end || *pos < '0' || *pos > '9') { return false; }
+			value = 0;
+			while (pos < end && *pos >= '0' && *pos <= '9') { value = value * 10 + (*pos - '0'); pos++; }
+			if (negative) { value = -value; }
+			return true;
+		}
+
+		Header header = {};
+		const uint8_t* image = nullptr;
+	};
+}
+
+#endif
@@ -141,11 +141,6 @@ public:
 		if (this->respawnManager) { this->respawnManager->died(this); }
 		this->screen->remove(this);
 	}
-
-	sf::Sprite* spritePtr()
-	{
-		return dynamic_cast<sf::Sprite*>(this->graphic);
-	}
 };
 
 #endif
@@ -0,0 +1,163 @@
+#ifndef DENSEOBJECTMAP_H
+#define DENSEOBJECTMAP_H
+
+#include "GameObject.h"
+#include <vector>
+
+namespace Engine
+{
+	//maps object ids to values, keeping the values packed in a vector so per frame passes walk contiguous memory
+	//the id is the stable handle: erasing moves the last element into the hole, so dense indices are not stable
+	//ids are looked up in an open addressing table, so once the map has grown, objects coming and going allocate nothing
+	template<typename T> class DenseObjectMap
+	{
+	public:
+		typedef typename std::vector<T>::const_iterator const_iterator;
+
+		//inserts the value, or replaces it if the id is already present
+		void insert(GameObjectID id, const T& value)
+		{
+			if (Slot* slot = this->findSlot(id))
+			{
+				this->values[slot->index] = value;
+				return;
+			}
+			if ((this->values.size() + 1) * 2 > this->slots.size()) { this->rehash((this->slots.empty()) ? 16 : this->slots.size() * 2); }
+			this->placeSlot(id, this->values.size());
+			this->values.push_back(value);
+			this->ids.push_back(id);
+		}
+
+		size_t erase(GameObjectID id)
+		{
+			Slot* slot = this->findSlot(id);
+			if (slot == nullptr) { return 0; }
+			size_t index = slot->index;
+			this->eraseSlot(slot);
+			size_t last = this->values.size() - 1;
+			if (index != last)
+			{
+				this->values[index] = this->values[last];
+				this->ids[index] = this->ids[last];
+				this->findSlot(this->ids[index])->index = index;
+			}
+			this->values.pop_back();
+			this->ids.pop_back();
+			return 1;
+		}
+
+		bool contains(GameObjectID id) const
+		{
+			return this->findSlot(id) != nullptr;
+		}
+
+		const T* get(GameObjectID id) const
+		{
+			const Slot* slot = this->findSlot(id);
+			return (slot != nullptr) ? &this->values[slot->index] : nullptr;
+		}
+
+		//access by dense index, for passes that must tolerate objects being added while they run
+		const T& operator[](size_t index) const
+		{
+			return this->values[index];
+		}
+
+		size_t size() const
+		{
+			return this->values.size();
+		}
+
+		bool empty() const
+		{
+			return this->values.empty();
+		}
+
+		void reserve(size_t count)
+		{
+			this->values.reserve(count);
+			this->ids.reserve(count);
+			size_t slotCount = 16;
+			while (slotCount < count * 2) { slotCount *= 2; }
+			if (slotCount > this->slots.size()) { this->rehash(slotCount); }
+		}
+
+		const_iterator begin() const
+		{
+			return this->values.begin();
+		}
+
+		const_iterator end() const
+		{
+			return this->values.end();
+		}
+
+	private:
+		//id 0 is never handed out, so it marks an empty slot
+		struct Slot
+		{
+			GameObjectID id;
+			size_t index;
+		};
+
+		size_t home(GameObjectID id) const
+		{
+			//ids are sequential, fibonacci hashing spreads them over the table
+			return static_cast<size_t>((id * 0x9E3779B97F4A7C15ULL) >> 32) & (this->slots.size() - 1);
+		}
+
+		Slot* findSlot(GameObjectID id)
+		{
+			return const_cast<Slot*>(static_cast<const DenseObjectMap*>(this)->findSlot(id));
+		}
+
+		const Slot* findSlot(GameObjectID id) const
+		{
+			if (this->slots.empty() || id == 0) { return nullptr; }
+			size_t mask = this->slots.size() - 1;
+			for (size_t i = this->home(id); ; i = (i + 1) & mask)
+			{
+				if (this->slots[i].id == id) { return &this->slots[i]; }
+				if (this->slots[i].id == 0) { return nullptr; }
+			}
+		}
+
+		void placeSlot(GameObjectID id, size_t index)
+		{
+			size_t mask = this->slots.size() - 1;
+			size_t i = this->home(id);
+			while (this->slots[i].id != 0) { i = (i + 1) & mask; }
+			this->slots[i] = { id, index };
+		}
+
+		//linear probing without tombstones: the following slots of the run are shifted back into the hole
+		void eraseSlot(Slot* slot)
+		{
+			size_t mask = this->slots.size() - 1;
+			size_t hole = static_cast<size_t>(slot - this->slots.data());
+			for (size_t i = (hole + 1) & mask; this->slots[i].id != 0; i = (i + 1) & mask)
+			{
+				size_t wanted = this->home(this->slots[i].id);
+				//a slot may fill the hole only if the hole lies between its home and where it is now
+				if (((i - wanted) & mask) >= ((i - hole) & mask))
+				{
+					this->slots[hole] = this->slots[i];
+					hole = i;
+				}
+			}
+			this->slots[hole] = { 0, 0 };
+		}
+
+		void rehash(size_t slotCount)
+		{
+			this->slots.assign(slotCount, { 0, 0 });
+			for (size_t i = 0; i < this->ids.size(); i++) { this->placeSlot(this->ids[i], i); }
+		}
+
+		std::vector<T> values;
+		std::vector<GameObjectID> ids;
+		std::vector<Slot> slots; //size is zero or a power of two, at most half full
+	};
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include "SFML/Graphics.hpp"
+#include "TileMap.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Engine
+{
+	//breadth first search outward from a target tile over the map's walkable tiles
+	//every reachable tile stores the step toward the target, so any number of agents can look up their next move in constant time
+	//the search is only redone when the target moves to another tile
+	class FlowField
+	{
+	public:
+		enum class Step : uint8_t { None, Up, Left, Down, Right };
+
+		static constexpr uint16_t unreachable = 0xFFFF;
+
+		//rebuilds the field if the target is on a different tile than last time, returns true if it did
+		bool update(const TileMap& map, sf::Vector2f target)
+		{
+			sf::Vector2i cell = cellOf(map, target);
+			bool sameMap = (this->map == &map && this->width == map.width() && this->height == map.height());
+			if (sameMap && cell == this->targetCell) { return false; }
+			this->map = &map;
+			this->width = map.width();
+			this->height = map.height();
+			this->targetCell = cell;
+			this->rebuild();
+			return true;
+		}
+
+		Step stepAt(sf::Vector2f position) const
+		{
+			int index = this->indexOf(position);
+			return (index < 0) ? Step::None : this->steps[static_cast<size_t>(index)];
+		}
+
+		//number of tiles to the target, unreachable if there is no path
+		uint16_t distanceAt(sf::Vector2f position) const
+		{
+			int index = this->indexOf(position);
+			return (index < 0) ? unreachable : this->distances[static_cast<size_t>(index)];
+		}
+
+		//the step for an agent whose terrain collision box is smaller than a tile
+		//before following a step along one axis the box is lined up with its tile on the other axis, so it does not catch on the corners of one tile wide gaps
+		Step steer(const sf::FloatRect& box) const
+		{
+			if (this->map == nullptr) { return Step::None; }
+			sf::Vector2f center(box.left + box.width / 2.f, box.top + box.height / 2.f);
+			Step step = this->stepAt(center);
+			if (step == Step::None) { return Step::None; }
+			sf::Vector2u tile = this->map->tileSize();
+			sf::Vector2i cell = cellOf(*this->map, center);
+			if (step == Step::Left || step == Step::Right)
+			{
+				float top = static_cast<float>(cell.y) * static_cast<float>(tile.y);
+				if (box.height <= static_cast<float>(tile.y))
+				{
+					if (box.top < top) { return Step::Down; }
+					if (box.top + box.height > top + static_cast<float>(tile.y)) { return Step::Up; }
+				}
+			}
+			else
+			{
+				float left = static_cast<float>(cell.x) * static_cast<float>(tile.x);
+				if (box.width <= static_cast<float>(tile.x))
+				{
+					if (box.left < left) { return Step::Right; }
+					if (box.left + box.width > left + static_cast<float>(tile.x)) { return Step::Left; }
+				}
+			}
+			return step;
+		}
+
+		uint64_t getRebuildCount() const
+		{
+			return this->rebuildCount;
+		}
+
+	private:
+		static sf::Vector2i cellOf(const TileMap& map, sf::Vector2f position)
+		{
+			sf::Vector2u tile = map.tileSize();
+			if (tile.x == 0 || tile.y == 0) { return sf::Vector2i(-1, -1); }
+			return sf::Vector2i(static_cast<int>(std::floor(position.x / static_cast<float>(tile.x))), static_cast<int>(std::floor(position.y / static_cast<float>(tile.y))));
+		}
+
+		int indexOf(sf::Vector2f position) const
+		{
+			if (this->map == nullptr) { return -1; }
+			sf::Vector2i cell = cellOf(*this->map, position);
+			if (static_cast<unsigned int>(cell.x) >= this->width || static_cast<unsigned int>(cell.y) >= this->height) { return -1; }
+			return cell.x + cell.y * static_cast<int>(this->width);
+		}
+
+		void rebuild()
+		{
+			size_t count = static_cast<size_t>(this->width) * static_cast<size_t>(this->height);
+			this->distances.assign(count, unreachable);
+			this->steps.assign(count, Step::None);
+			this->rebuildCount++;
+			int target = this->targetCell.x + this->targetCell.y * static_cast<int>(this->width);
+			if (static_cast<unsigned int>(this->targetCell.x) >= this->width || static_cast<unsigned int>(this->targetCell.y) >= this->height) { return; }
+
+			//the target tile is searched from even if it is an obstacle, the player can stand partly over one
+			this->frontier.clear();
+			this->frontier.push_back(target);
+			this->distances[static_cast<size_t>(target)] = 0;
+			for (size_t head = 0; head < this->frontier.size(); head++)
+			{
+				int index = this->frontier[head];
+				int i = index % static_cast<int>(this->width);
+				int j = index / static_cast<int>(this->width);
+				uint16_t nextDistance = static_cast<uint16_t>(this->distances[static_cast<size_t>(index)] + 1);
+				//each neighbour's step points back at the tile it was reached from
+				const struct { int di; int dj; Step back; } neighbours[4] = {
+					{ 0, -1, Step::Down }, { -1, 0, Step::Right }, { 0, 1, Step::Up }, { 1, 0, Step::Left }
+				};
+				for (auto const & n : neighbours)
+				{
+					int ni = i + n.di;
+					int nj = j + n.dj;
+					if (static_cast<unsigned int>(ni) >= this->width || static_cast<unsigned int>(nj) >= this->height) { continue; }
+					size_t neighbour = static_cast<size_t>(ni + nj * static_cast<int>(this->width));
+					if (this->distances[neighbour] != unreachable) { continue; }
+					if (this->map->getFlagsAtCell(ni, nj) & TileProperties::Obstacle) { continue; }
+					this->distances[neighbour] = (nextDistance < unreachable) ? nextDistance : static_cast<uint16_t>(unreachable - 1);
+					this->steps[neighbour] = n.back;
+					this->frontier.push_back(static_cast<int>(neighbour));
+				}
+			}
+		}
+
+		const TileMap* map = nullptr;
+		unsigned int width = 0;
+		unsigned int height = 0;
+		sf::Vector2i targetCell = sf::Vector2i(-1, -1);
+		std::vector<uint16_t> distances;
+		std::vector<Step> steps;
+		std::vector<int> frontier;
+		uint64_t rebuildCount = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include "SFML/Graphics.hpp"
+#include <cstdint>
+
+namespace Engine
+{
+	//holds the game loop to a target frame rate without pinning a core
+	class FramePacer
+	{
+	public:
+		enum class Mode
+		{
+			HybridSleep, //sleeps for most of the remaining frame time, then spins for the last stretch to hit the deadline precisely
+			Sleep, //only sleeps, which uses the least cpu but is subject to the operating system's timer resolution
+			VSync, //lets the driver block on display(), the target frame rate is only used for jitter reporting
+			Uncapped //runs as fast as possible
+		};
+
+		FramePacer(unsigned int targetFrameRate = 60U, Mode mode = Mode::HybridSleep) : targetFrameRate(targetFrameRate), mode(mode) { }
+
+		void setTargetFrameRate(unsigned int fps)
+		{
+			this->targetFrameRate = fps;
+		}
+
+		unsigned int getTargetFrameRate() const
+		{
+			return this->targetFrameRate;
+		}
+
+		void setMode(Mode mode)
+		{
+			this->mode = mode;
+		}
+
+		Mode getMode() const
+		{
+			return this->mode;
+		}
+
+		sf::Int64 getFrameDurationMicroseconds() const
+		{
+			return (this->targetFrameRate > 0U) ? (1000000 / static_cast<sf::Int64>(this->targetFrameRate)) : 0;
+		}
+
+		//configures the window for the current mode, call this whenever the mode changes
+		void apply(sf::Window& window)
+		{
+			window.setFramerateLimit(0U);
+			window.setVerticalSyncEnabled(this->mode == Mode::VSync);
+			this->nextFrameTime = this->clock.getElapsedTime().asMicroseconds();
+			this->lastFrameEnd = this->nextFrameTime;
+		}
+
+		//blocks until the next frame is due and records how far the frame landed from its target
+		void waitForNextFrame()
+		{
+			sf::Int64 frameDuration = this->getFrameDurationMicroseconds();
+			if ((this->mode == Mode::HybridSleep || this->mode == Mode::Sleep) && frameDuration > 0)
+			{
+				this->nextFrameTime += frameDuration;
+				sf::Int64 now = this->clock.getElapsedTime().asMicroseconds();
+				if (now >= this->nextFrameTime) { this->nextFrameTime = now; } //frame overran, start the next one from now instead of bursting to catch up
+				else if (this->mode == Mode::Sleep) { sf::sleep(sf::microseconds(this->nextFrameTime - now)); }
+				else
+				{
+					if (this->nextFrameTime - now > spinThresholdMicroseconds) { sf::sleep(sf::microseconds(this->nextFrameTime - now - spinThresholdMicroseconds)); }
+					while (this->clock.getElapsedTime().asMicroseconds() < this->nextFrameTime) {}
+				}
+			}
+
+			sf::Int64 frameEnd = this->clock.getElapsedTime().asMicroseconds();
+			if (frameDuration > 0)
+			{
+				sf::Int64 jitter = (frameEnd - this->lastFrameEnd) - frameDuration;
+				if (jitter < 0) { jitter = -jitter; }
+				this->jitterSum += jitter;
+				if (jitter > this->jitterMax) { this->jitterMax = jitter; }
+				this->jitterSamples++;
+			}
+			this->lastFrameEnd = frameEnd;
+		}
+
+		sf::Int64 getAverageJitterMicroseconds() const
+		{
+			return (this->jitterSamples > 0) ? (this->jitterSum / static_cast<sf::Int64>(this->jitterSamples)) : 0;
+		}
+
+		sf::Int64 getMaxJitterMicroseconds() const
+		{
+			return this->jitterMax;
+		}
+
+		void resetJitterStatistics()
+		{
+			this->jitterSum = 0;
+			this->jitterMax = 0;
+			this->jitterSamples = 0;
+		}
+
+	private:
+		static constexpr sf::Int64 spinThresholdMicroseconds = 2000;
+		unsigned int targetFrameRate;
+		Mode mode;
+		sf::Clock clock;
+		sf::Int64 nextFrameTime = 0;
+		sf::Int64 lastFrameEnd = 0;
+		sf::Int64 jitterSum = 0;
+		sf::Int64 jitterMax = 0;
+		uint64_t jitterSamples = 0;
+	};
+}
+
+#endif
@@ -1,4 +1,6 @@
 #include "GameObject.h"
+#include "SpriteBatch.h"
+#include "Screen.h"
 
 namespace Engine
 {
@@ -14,49 +16,136 @@ namespace Engine
 		this->id = generateID();
 	}
 
+	void GameObject::renewID()
+	{
+		this->id = generateID();
+	}
+
+	void GameObject::subscribeEvents(uint8_t groups)
+	{
+		this->eventSubscriptions |= groups;
+		if (this->screen) { this->screen->updateEventSubscriptions(this); }
+	}
+
+	void GameObject::unsubscribeEvents(uint8_t groups)
+	{
+		this->eventSubscriptions &= static_cast<uint8_t>(~groups);
+		if (this->screen) { this->screen->updateEventSubscriptions(this); }
+	}
+
+	GameObject::EventGroup GameObject::eventGroupOf(sf::Event::EventType type)
+	{
+		switch (type)
+		{
+		case sf::Event::Resized:
+		case sf::Event::LostFocus:
+		case sf::Event::GainedFocus:
+			return WindowEvents;
+		case sf::Event::TextEntered:
+			return TextEvents;
+		case sf::Event::KeyPressed:
+		case sf::Event::KeyReleased:
+			return KeyEvents;
+		case sf::Event::MouseButtonPressed:
+		case sf::Event::MouseButtonReleased:
+			return MouseButtonEvents;
+		case sf::Event::MouseMoved:
+		case sf::Event::MouseEntered:
+		case sf::Event::MouseLeft:
+			return MouseMoveEvents;
+		case sf::Event::MouseWheelMoved:
+		case sf::Event::MouseWheelScrolled:
+			return MouseWheelEvents;
+		case sf::Event::JoystickButtonPressed:
+		case sf::Event::JoystickButtonReleased:
+		case sf::Event::JoystickMoved:
+		case sf::Event::JoystickConnected:
+		case sf::Event::JoystickDisconnected:
+			return JoystickEvents;
+		case sf::Event::TouchBegan:
+		case sf::Event::TouchMoved:
+		case sf::Event::TouchEnded:
+		case sf::Event::SensorChanged:
+			return TouchEvents;
+		default:
+			return NoEvents;
+		}
+	}
+
 	GraphicalGameObject::GraphicalGameObject(sf::Sprite s)
 	{
-		this->graphic = new sf::Sprite(s);
+		this->storeGraphic(std::move(s), GraphicType::Sprite);
 	}
 
 	GraphicalGameObject::GraphicalGameObject(sf::CircleShape cs)
 	{
-		this->graphic = new sf::CircleShape(cs);
+		this->storeGraphic(std::move(cs), GraphicType::CircleShape);
 	}
 
 	GraphicalGameObject::GraphicalGameObject(sf::ConvexShape cx)
 	{
-		this->graphic = new sf::ConvexShape(cx);
+		this->storeGraphic(std::move(cx), GraphicType::ConvexShape);
 	}
 
 	GraphicalGameObject::GraphicalGameObject(sf::RectangleShape r)
 	{
-		this->graphic = new sf::RectangleShape(r);
+		this->storeGraphic(std::move(r), GraphicType::RectangleShape);
 	}
 
 	GraphicalGameObject::GraphicalGameObject(sf::Text t)
 	{
-		this->graphic = new sf::Text(t);
+		this->storeGraphic(std::move(t), GraphicType::Text);
 	}
 
 	GraphicalGameObject::GraphicalGameObject(sf::VertexArray va)
 	{
-		this->graphic = new sf::VertexArray(va);
+		this->storeGraphic(std::move(va), GraphicType::VertexArray);
 	}
 
 	GraphicalGameObject::GraphicalGameObject(sf::VertexBuffer vb)
 	{
-		this->graphic = new sf::VertexBuffer(vb);
+		this->storeGraphic(std::move(vb), GraphicType::VertexBuffer);
 	}
 
+	SpriteBatch* GraphicalGameObject::activeBatch = nullptr;
+
 	void GraphicalGameObject::draw(sf::RenderWindow& win)
 	{
+		if (GraphicalGameObject::activeBatch != nullptr)
+		{
+			this->defaultDraw = true;
+			sf::Sprite* sprite = this->getSprite();
+			if (sprite != nullptr && GraphicalGameObject::activeBatch->add(*sprite)) { return; }
+		}
 		win.draw(*this->graphic);
 	}
 
 	GraphicalGameObject::~GraphicalGameObject()
 	{
-		delete this->graphic;
+		switch (this->graphicType)
+		{
+		case GraphicType::Sprite:
+			static_cast<sf::Sprite*>(this->graphic)->~Sprite();
+			break;
+		case GraphicType::CircleShape:
+			static_cast<sf::CircleShape*>(this->graphic)->~CircleShape();
+			break;
+		case GraphicType::ConvexShape:
+			static_cast<sf::ConvexShape*>(this->graphic)->~ConvexShape();
+			break;
+		case GraphicType::RectangleShape:
+			static_cast<sf::RectangleShape*>(this->graphic)->~RectangleShape();
+			break;
+		case GraphicType::Text:
+			static_cast<sf::Text*>(this->graphic)->~Text();
+			break;
+		case GraphicType::VertexArray:
+			static_cast<sf::VertexArray*>(this->graphic)->~VertexArray();
+			break;
+		case GraphicType::VertexBuffer:
+			static_cast<sf::VertexBuffer*>(this->graphic)->~VertexBuffer();
+			break;
+		}
 	}
 
 	sf::Drawable* GraphicalGameObject::getGraphic()
@@ -64,6 +153,37 @@ namespace Engine
 		return this->graphic;
 	}
 
+	sf::Shape* GraphicalGameObject::getShape()
+	{
+		switch (this->graphicType)
+		{
+		case GraphicType::CircleShape:
+			return static_cast<sf::CircleShape*>(this->graphic);
+		case GraphicType::ConvexShape:
+			return static_cast<sf::ConvexShape*>(this->graphic);
+		case GraphicType::RectangleShape:
+			return static_cast<sf::RectangleShape*>(this->graphic);
+		default:
+			return nullptr;
+		}
+	}
+
+	sf::Transformable* GraphicalGameObject::getTransformable()
+	{
+		switch (this->graphicType)
+		{
+		case GraphicType::Sprite:
+			return static_cast<sf::Sprite*>(this->graphic);
+		case GraphicType::Text:
+			return static_cast<sf::Text*>(this->graphic);
+		case GraphicType::VertexArray:
+		case GraphicType::VertexBuffer:
+			return nullptr;
+		default:
+			return this->getShape();
+		}
+	}
+
 	void GameObject::EveryFrame(uint64_t frameNumber)
 	{
 
@@ -5,14 +5,32 @@
 #include <cstdint>
 #include <map>
 #include <iostream>
+#include <type_traits>
 
 namespace Engine
 {
 	typedef uint64_t GameObjectID;
 	class Screen;
+	class SpriteBatch;
+	template<typename T> class ObjectPool;
 	class GameObject
 	{
 	public:
+		//groups of sfml events, Screen only hands an event to the objects subscribed to its group
+		enum EventGroup : uint8_t
+		{
+			NoEvents = 0,
+			WindowEvents = 1, //Resized, LostFocus, GainedFocus
+			TextEvents = 2,
+			KeyEvents = 4,
+			MouseButtonEvents = 8,
+			MouseMoveEvents = 16, //MouseMoved, MouseEntered, MouseLeft
+			MouseWheelEvents = 32,
+			JoystickEvents = 64,
+			TouchEvents = 128, //touches and SensorChanged
+			AllEvents = 255
+		};
+		static EventGroup eventGroupOf(sf::Event::EventType type); //NoEvents for Closed, which Screen handles itself
 		GameObject();
 		//sfml events
 		virtual void Resized(sf::Event event);                ///< The window was resized (data in event.size)
@@ -45,14 +63,22 @@ namespace Engine
 		void disableEvents() { this->eventsDisabled = true; }
 		void enableEvents() { this->eventsDisabled = false; }
 		Screen* getScreenPtr() const { return this->screen; }
+		uint8_t getEventSubscriptions() const { return this->eventSubscriptions; }
 	private:
 		GameObject(GameObjectID id);
 		void dispatchEvent(sf::Event);
+		template<typename T> friend class ObjectPool;
+		void renewID(); //a recycled object gets a new id, so nothing mistakes it for the object it was before
 	protected:
 		friend class Screen;
 		GameObjectID id;
 		Screen* screen = nullptr;
+		//objects receive no events until they subscribe, usually from the constructor
+		void subscribeEvents(uint8_t groups);
+		void unsubscribeEvents(uint8_t groups);
 		bool eventsDisabled = false;
+		uint8_t eventSubscriptions = NoEvents;
+		bool pooled = false; //owned by an ObjectPool, Screen hands it back through RemovedFromScreen instead of deleting it
 	};
 
 	class GraphicalGameObject : public GameObject
@@ -66,15 +92,37 @@ namespace Engine
 		GraphicalGameObject(sf::Text);
 		GraphicalGameObject(sf::VertexArray);
 		GraphicalGameObject(sf::VertexBuffer);
+		GraphicalGameObject(const GraphicalGameObject&) = delete;
+		GraphicalGameObject& operator=(const GraphicalGameObject&) = delete;
 		virtual void draw(sf::RenderWindow& win);
 		virtual ~GraphicalGameObject();
 		sf::Drawable* getGraphic();
+		//typed access to the graphic without a cast, each returns nullptr if the graphic is something else
+		sf::Sprite* getSprite() { return (this->graphicType == GraphicType::Sprite) ? static_cast<sf::Sprite*>(this->graphic) : nullptr; }
+		sf::Text* getText() { return (this->graphicType == GraphicType::Text) ? static_cast<sf::Text*>(this->graphic) : nullptr; }
+		sf::RectangleShape* getRectangleShape() { return (this->graphicType == GraphicType::RectangleShape) ? static_cast<sf::RectangleShape*>(this->graphic) : nullptr; }
+		sf::Shape* getShape();
+		sf::Transformable* getTransformable();
 	protected:
-		sf::Drawable* graphic;
+		sf::Drawable* graphic; //points into graphicStorage
 	private:
+		enum class GraphicType : uint8_t { Sprite, CircleShape, ConvexShape, RectangleShape, Text, VertexArray, VertexBuffer };
+		template<typename T> void storeGraphic(T&& drawable, GraphicType type)
+		{
+			this->graphic = new (&this->graphicStorage) typename std::decay<T>::type(std::forward<T>(drawable));
+			this->graphicType = type;
+		}
+		//the drawable lives inside the object instead of in its own allocation
+		typename std::aligned_union<0, sf::Sprite, sf::CircleShape, sf::ConvexShape, sf::RectangleShape, sf::Text, sf::VertexArray, sf::VertexBuffer>::type graphicStorage;
+		GraphicType graphicType;
 		friend class Screen;
 		bool spawnCollisionsResolved = false;
 		sf::Vector2f lastPos;
+		//set by Screen while it draws, the default draw hands sprites to it instead of drawing them one at a time
+		static SpriteBatch* activeBatch;
+		//true once the default draw has run for this object, Screen then batches its sprite without calling draw
+		//an override that also calls GraphicalGameObject::draw would lose its own drawing, call win.draw directly instead
+		bool defaultDraw = false;
 	};
 }
 
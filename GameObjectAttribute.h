@@ -15,16 +15,24 @@ namespace Engine
 		public:
 			PtrType* getDrawablePtr() const
 			{
-				if (this->drawablePtr == nullptr)
+				if (!this->drawableResolved)
 				{
 					GraphicalGameObjectDrawablePointerAccess* _this = const_cast<GraphicalGameObjectDrawablePointerAccess*>(this);
-					if (GraphicalGameObject* ggo = dynamic_cast<GraphicalGameObject*>(_this)) { _this->drawablePtr = dynamic_cast<PtrType*>(ggo->getGraphic()); }
+					if (GraphicalGameObject* ggo = dynamic_cast<GraphicalGameObject*>(_this)) { _this->resolveDrawablePtr(ggo->getGraphic()); }
 				}
 				return this->drawablePtr;
 			}
 		private:
+			friend class Screen;
+			//Screen calls this when the object is added so the cast never runs on a per frame path
+			void resolveDrawablePtr(sf::Drawable* graphic)
+			{
+				this->drawablePtr = dynamic_cast<PtrType*>(graphic);
+				this->drawableResolved = true;
+			}
 			virtual void _() {}
 			PtrType* drawablePtr = nullptr;
+			bool drawableResolved = false;
 		};
 
 		class GameObjectScreenAccess
@@ -241,8 +249,9 @@ namespace Engine
 			}
 		private:
 			friend class Screen;
-			double xVelocity;
-			double yVelocity;
+			double xVelocity = 0.0;
+			double yVelocity = 0.0;
+			sf::Vector2f lastDisplacement; //distance moved in the last simulation step, used to interpolate the drawn position
 		};
 
 		//provides the sprite sheet functionality
@@ -289,8 +298,8 @@ namespace Engine
 					{
 						this->sheet->init();
 						s->setTextureRect({
-							this->sheet->spriteSheetRow * static_cast<int>(this->sheet->textureSize.x),
-							this->sheet->spriteSheetColumn * static_cast<int>(this->sheet->textureSize.y),
+							this->sheet->textureOrigin.x + this->sheet->spriteSheetRow * static_cast<int>(this->sheet->textureSize.x),
+							this->sheet->textureOrigin.y + this->sheet->spriteSheetColumn * static_cast<int>(this->sheet->textureSize.y),
 							static_cast<int>(this->sheet->textureSize.x),
 							static_cast<int>(this->sheet->textureSize.y)
 						});
@@ -314,13 +323,15 @@ namespace Engine
 			{
 				if (this->initialized) { return; }
 				this->initialized = true;
-				sf::Sprite* s = this->getDrawablePtr();
-				const sf::Texture* t = s->getTexture();
-				this->textureSize = t->getSize();
+				//the sheet is the sprite's starting texture rect, which is only part of the texture when it comes from an atlas
+				sf::IntRect sheetRect = this->getDrawablePtr()->getTextureRect();
+				this->textureOrigin = sf::Vector2i(sheetRect.left, sheetRect.top);
+				this->textureSize = sf::Vector2u(static_cast<unsigned int>(sheetRect.width), static_cast<unsigned int>(sheetRect.height));
 				this->textureSize.x /= (this->spriteSheetRow.max > 0) ? this->spriteSheetRow.max : 1;
 				this->textureSize.y /= (this->spriteSheetColumn.max > 0) ? this->spriteSheetColumn.max : 1 ;
 			}
 			bool initialized = false;
+			sf::Vector2i textureOrigin;
 			sf::Vector2u textureSize;
 		};
 	};
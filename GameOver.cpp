@@ -6,27 +6,28 @@
 
 GameOver::GameOver(int finalScore, DifficultySettings::DIFFICULTY difficulty) : GraphicalGameObject(SpriteFactory::generateSprite(Sprite::ID::Gameover)), finalScore(finalScore), difficulty(difficulty)
 {
-	this->spritePtr()->setColor({ 255, 255, 255, 0 });
+	this->subscribeEvents(MouseButtonEvents);
+	this->getSprite()->setColor({ 255, 255, 255, 0 });
 	this->backSprite = SpriteFactory::generateSprite(Sprite::ID::GameoverBack);
 	this->backSprite.setColor({ 255, 255, 255, 255 });
 }
 
 void GameOver::AddedToScreen()
 {
-	sf::IntRect size = this->spritePtr()->getTextureRect();
+	sf::IntRect size = this->getSprite()->getTextureRect();
 	sf::Vector2f pos;
 	pos.x = static_cast<float>(Screen::windowWidth / 2 - size.width / 2);
 	pos.y = static_cast<float>(Screen::windowHeight / 2 - size.height / 2);
-	this->spritePtr()->setPosition(pos);
+	this->getSprite()->setPosition(pos);
 }
 
 void GameOver::EveryFrame(uint64_t f)
 {
 	if (this->internalClock++ < 255)
 	{
-		sf::Color color = this->spritePtr()->getColor();
+		sf::Color color = this->getSprite()->getColor();
 		color.a++;
-		this->spritePtr()->setColor(color);
+		this->getSprite()->setColor(color);
 	}
 }
 
@@ -47,10 +48,10 @@ void GameOver::MouseButtonReleased(sf::Event e)
 
 void GameOver::draw(sf::RenderWindow& win)
 {
-	win.draw(*this->spritePtr());
+	win.draw(*this->getSprite());
 	if (this->internalClock > 255)
 	{
-		sf::Vector2f pos = this->spritePtr()->getPosition();
+		sf::Vector2f pos = this->getSprite()->getPosition();
 		sf::IntRect backSize = this->backSprite.getTextureRect();
 		pos.x += static_cast<float>(backSize.width) * 1.5f;
 		pos.y += 150.f;
@@ -14,7 +14,6 @@ private:
 	int finalScore = 0;
 	int internalClock = 0;
 	sf::Sprite backSprite;
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->graphic); }
 public:
 	GameOver(int finalScore, DifficultySettings::DIFFICULTY difficulty);
 	void AddedToScreen();
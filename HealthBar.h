@@ -8,7 +8,7 @@ class HealthBar : public GraphicalGameObject
 {
 private:
 	sf::RectangleShape* maxPtr() { return &this->maxHealthBar; } //max health
-	sf::RectangleShape* currPtr() { return dynamic_cast<sf::RectangleShape*>(this->getGraphic()); }	//current health
+	sf::RectangleShape* currPtr() { return this->getRectangleShape(); }	//current health
 	MainCharacter* character = nullptr;
 	sf::RectangleShape maxHealthBar;
 	sf::Clock alarmClock;
@@ -0,0 +1,94 @@
+#ifndef INPUTSOURCE_H
+#define INPUTSOURCE_H
+
+#include "SFML/Graphics.hpp"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace Engine
+{
+	//supplies the events a headless screen receives on each simulation step
+	class InputSource
+	{
+	public:
+		virtual ~InputSource() {}
+		virtual void poll(uint64_t step, std::vector<sf::Event>& events) = 0; //appends the events for the given step, counted from the start of the headless run
+		virtual sf::Vector2i getMousePosition() const { return sf::Vector2i(0, 0); } //mouse position in world coordinates
+	};
+
+	//replays a fixed list of events, each tagged with the simulation step it is delivered on
+	class ScriptedInput : public InputSource
+	{
+	public:
+		void add(uint64_t step, sf::Event ev)
+		{
+			this->script[step].push_back(ev);
+		}
+
+		void keyPressed(uint64_t step, sf::Keyboard::Key key)
+		{
+			sf::Event ev;
+			ev.type = sf::Event::KeyPressed;
+			ev.key = { key, false, false, false, false };
+			this->add(step, ev);
+		}
+
+		void keyReleased(uint64_t step, sf::Keyboard::Key key)
+		{
+			sf::Event ev;
+			ev.type = sf::Event::KeyReleased;
+			ev.key = { key, false, false, false, false };
+			this->add(step, ev);
+		}
+
+		void mouseMoved(uint64_t step, int x, int y)
+		{
+			sf::Event ev;
+			ev.type = sf::Event::MouseMoved;
+			ev.mouseMove = { x, y };
+			this->add(step, ev);
+		}
+
+		void mouseClicked(uint64_t step, sf::Mouse::Button button, int x, int y)
+		{
+			sf::Event ev;
+			ev.type = sf::Event::MouseButtonPressed;
+			ev.mouseButton = { button, x, y };
+			this->add(step, ev);
+			ev.type = sf::Event::MouseButtonReleased;
+			this->add(step, ev);
+		}
+
+		void textEntered(uint64_t step, uint32_t unicode)
+		{
+			sf::Event ev;
+			ev.type = sf::Event::TextEntered;
+			ev.text = { unicode };
+			this->add(step, ev);
+		}
+
+		void poll(uint64_t step, std::vector<sf::Event>& events)
+		{
+			auto iter = this->script.find(step);
+			if (iter == this->script.end()) { return; }
+			for (auto const & ev : iter->second)
+			{
+				if (ev.type == sf::Event::MouseMoved) { this->mousePosition = { ev.mouseMove.x, ev.mouseMove.y }; }
+				else if (ev.type == sf::Event::MouseButtonPressed || ev.type == sf::Event::MouseButtonReleased) { this->mousePosition = { ev.mouseButton.x, ev.mouseButton.y }; }
+				events.push_back(ev);
+			}
+		}
+
+		sf::Vector2i getMousePosition() const
+		{
+			return this->mousePosition;
+		}
+
+	private:
+		std::map<uint64_t, std::vector<sf::Event>> script;
+		sf::Vector2i mousePosition;
+	};
+}
+
+#endif
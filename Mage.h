@@ -20,7 +20,7 @@ class MageHealthBar : public GraphicalGameObject
 {
 private:
 	int maxHealth;
-	sf::RectangleShape* rectPtr() { return dynamic_cast<sf::RectangleShape*>(this->graphic); }
+	sf::RectangleShape* rectPtr() { return this->getRectangleShape(); }
 public:
 	MageHealthBar() : GraphicalGameObject(sf::RectangleShape())
 	{
@@ -66,10 +66,6 @@ private:
 	//sf::Vector2u currentImage;
 	MageHealthBar* healthBar = nullptr;
 	RespawnManager<Mage>* respawnManager = nullptr;
-	sf::Sprite* spritePtr()
-	{
-		return dynamic_cast<sf::Sprite*>(this->graphic);
-	}
 public:
 	Mage(sf::Sprite s, RespawnManager<Mage>* respawnManager) : Mage(s)
 	{
@@ -89,6 +85,17 @@ public:
 			this->imageCount.y * this->textureSize.y, this->textureSize.x, this->textureSize.y));*/
 
 		this->resetSpriteSheet();
+
+		//collide with terrain at the feet like the player, small enough to follow the flow field through one tile gaps
+		sf::IntRect size = this->getSprite()->getTextureRect();
+		sf::Vector2f collisionSizeRatio(0.4f, 0.3f);
+		sf::FloatRect collisionSize;
+		collisionSize.width = static_cast<float>(size.width) * collisionSizeRatio.x;
+		collisionSize.height = static_cast<float>(size.height) * collisionSizeRatio.y;
+		collisionSize.left = ((1.f - collisionSizeRatio.x) * static_cast<float>(size.width)) / 2.f;
+		collisionSize.top = ((1.f - collisionSizeRatio.y) * static_cast<float>(size.height));
+		this->setObstacleCollisionSize(collisionSize);
+
 		this->movingUp = false;
 		this->movingLeft = false;
 		this->movingDown = false;
@@ -120,7 +127,7 @@ public:
 	{
 		this->healthBar = new MageHealthBar();
 		healthBar->setMaxHealth(this->getHealth());
-		sf::Vector2f pos = this->spritePtr()->getPosition();
+		sf::Vector2f pos = this->getSprite()->getPosition();
 		pos.y -= 10.f;
 		pos.x += 5.f;
 		this->healthBar->setCurrHealth(this->getHealth());
@@ -134,16 +141,31 @@ public:
 		srand(static_cast<unsigned int>(time(0) * this->getID()));
 		if (this->isAlive())
 		{
-			sf::Vector2f healthBarPos = this->spritePtr()->getPosition();
+			sf::Vector2f healthBarPos = this->getSprite()->getPosition();
 			healthBarPos.y -= 10.f;
 			healthBarPos.x += 5.f;
 			this->healthBar->setPosition(healthBarPos);
 
-			if (this->internalClock % 120 == 0)
+			//follow the shared flow field toward the player, it has no step once the mage is on the player's tile or has no path
+			FlowField::Step step = FlowField::Step::None;
+			if (this->screen->getMap() != nullptr)
+			{
+				sf::FloatRect box = this->getObstacleCollisionSize();
+				box.left += this->getSprite()->getPosition().x;
+				box.top += this->getSprite()->getPosition().y;
+				step = this->screen->getPlayerFlowField().steer(box);
+			}
+			if (step != FlowField::Step::None)
+			{
+				this->movingUp = (step == FlowField::Step::Up);
+				this->movingLeft = (step == FlowField::Step::Left);
+				this->movingDown = (step == FlowField::Step::Down);
+				this->movingRight = (step == FlowField::Step::Right);
+			}
+			else if (this->internalClock % 120 == 0)
 			{
-				GraphicalGameObject* player = dynamic_cast<GraphicalGameObject*>(this->screen->getMainCharacter());
-				sf::Vector2f playerPosition = dynamic_cast<sf::Transformable*>(player->getGraphic())->getPosition();
-				sf::Vector2f myPosition = this->spritePtr()->getPosition();
+				sf::Vector2f playerPosition = this->screen->getMainCharacterPosition();
+				sf::Vector2f myPosition = this->getSprite()->getPosition();
 				DIRECTION xDirection = (playerPosition.x > myPosition.x) ? DIRECTION::RIGHT : DIRECTION::LEFT;
 				DIRECTION yDirection = (playerPosition.y > myPosition.y) ? DIRECTION::DOWN : DIRECTION::UP;
 
@@ -221,9 +243,9 @@ public:
 
 			if (this->internalClock % 100 == 0)
 			{
-				sf::Vector2f pos = this->spritePtr()->getPosition();
-				sf::Vector2f playerPos = dynamic_cast<sf::Transformable*>(dynamic_cast<GraphicalGameObject*>(this->screen->getMainCharacter())->getGraphic())->getPosition();
-				MageBlast* blast = new MageBlast(pos, playerPos, 1.5 + static_cast<double>(DifficultySettings::Mage::blastSpeedModifier), 135);
+				sf::Vector2f pos = this->getSprite()->getPosition();
+				sf::Vector2f playerPos = this->screen->getMainCharacterPosition();
+				MageBlast* blast = MageBlast::create(pos, playerPos, 1.5 + static_cast<double>(DifficultySettings::Mage::blastSpeedModifier), 135);
 				this->screen->add(blast);
 			}
 
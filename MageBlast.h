@@ -6,6 +6,8 @@
 #include "FileLoadException.h"
 #include "SpriteFactory.h"
 #include "GameObjectAttribute.h"
+#include "ObjectPool.h"
+#include "DifficultySettings.h"
 
 using namespace Engine;
 
@@ -26,24 +28,49 @@ private:
 	int life;
 	int hitsAgainstPlayer = 0;
 	float rotationRate;
-public:
+
+	friend class ObjectPool<MageBlast>;
 	MageBlast(const sf::Vector2f& pos, const sf::Vector2f& destination, double speed, int duration) :
 		GraphicalGameObject(SpriteFactory::generateSprite(Sprite::ID::Mageblast))
 	{
-		this->spritePtr()->setPosition(pos);
-		sf::Vector2u size = this->spritePtr()->getTexture()->getSize();
-		this->spritePtr()->setOrigin(static_cast<float>(size.x) / 2.f, static_cast<float>(size.y) / 2.f);
+		this->reset(pos, destination, speed, duration);
+	}
+
+	void reset(const sf::Vector2f& pos, const sf::Vector2f& destination, double speed, int duration)
+	{
+		*this->getSprite() = SpriteFactory::generateSprite(Sprite::ID::Mageblast); //undoes the rotation, scale and fade of a recycled blast
+		this->getSprite()->setPosition(pos);
+		sf::IntRect size = this->getSprite()->getTextureRect();
+		this->getSprite()->setOrigin(static_cast<float>(size.width) / 2.f, static_cast<float>(size.height) / 2.f);
 		double radians = atan2(static_cast<double>(destination.y - pos.y), static_cast<double>(destination.x - pos.x));
 		this->baseSpeed = { static_cast<float>(speed * cos(radians)), static_cast<float>(speed * sin(radians)) };
 		this->movePerFrame = this->baseSpeed;
 		this->life = duration;
+		this->hitsAgainstPlayer = 0;
 		srand(static_cast<unsigned int>(this->getID()));
 		this->rotationRate = (rand() % 2 == 0) ? 3.5f : -3.5f;
 	}
 
+	static ObjectPool<MageBlast>& getPool()
+	{
+		static ObjectPool<MageBlast> pool;
+		return pool;
+	}
+public:
+	//blasts are recycled, a removed blast goes back to the pool for the next shot
+	static MageBlast* create(const sf::Vector2f& pos, const sf::Vector2f& destination, double speed, int duration)
+	{
+		return getPool().acquire(pos, destination, speed, duration);
+	}
+
+	void RemovedFromScreen()
+	{
+		getPool().release(this);
+	}
+
 	void EveryFrame(uint64_t f)
 	{
-		sf::Sprite* spr = this->spritePtr();
+		sf::Sprite* spr = this->getSprite();
 		this->move(this->movePerFrame);
 		spr->rotate(this->rotationRate);
 		spr->setScale(cos(static_cast<float>(this->life)), sin(static_cast<float>(this->life)));
@@ -80,11 +107,6 @@ public:
 	{
 		return this->hitsAgainstPlayer;
 	}
-
-	sf::Sprite* spritePtr()
-	{
-		return dynamic_cast<sf::Sprite*>(this->graphic);
-	}
 };
 
 #endif
\ No newline at end of file
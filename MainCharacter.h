@@ -68,6 +68,7 @@ public:
 		SpriteSheet(4, 12)
 	{
 		this->name = name;
+		this->subscribeEvents(KeyEvents | MouseButtonEvents);
 		this->resetSpriteSheet();
 		sf::IntRect size = this->getDrawablePtr()->getTextureRect();
 		sf::Vector2f collisionSizeRatio(0.4f, 0.3f); //these numbers shrink the collision size of the player, and the code below adjusts it to be positioned at the bottom of the sprite
@@ -156,14 +157,14 @@ public:
 			{
 				SoundPlayer::play(SoundEffect::ID::ZombieAttack, 40.f);
 				if (this->getHealthPercent() > 0.2) { this->changeHealth(-1 * this->attackHealthCost); } //health cost of ranged attack only applies if health is above 20%
-				ZombieBlast* blast = new ZombieBlast(Sprite::ID::Blast, shotOrigin, sf::Vector2f(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y)), 3.5f, 140);
+				ZombieBlast* blast = ZombieBlast::create(Sprite::ID::Blast, shotOrigin, sf::Vector2f(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y)), 3.5f, 140);
 				//ZombieBlast* blast = new ZombieBlast(Sprite::ID::Blast, sf::Vector2f(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y)), shotOrigin, 3.5f, 140);
 				this->screen->add(blast);
 			}
 			else if (this->potionNum > 0)
 			{
 				SoundPlayer::play(SoundEffect::ID::ZombieAttack, 40.f);
-				SuperZombieBlast* blast = new SuperZombieBlast(Sprite::ID::Brain, shotOrigin, sf::Vector2f(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y)), 2.25f, 180, 1000, 0.1f, 0.2f);
+				SuperZombieBlast* blast = SuperZombieBlast::create(Sprite::ID::Brain, shotOrigin, sf::Vector2f(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y)), 2.25f, 180, 1000, 0.1f, 0.2f);
 				this->screen->add(blast);
 				this->potionNum--;
 			}
@@ -367,8 +368,8 @@ public:
 				float time = this->aliveClock.getElapsedTime().asSeconds();
 				float timeAmplifier = 1.f + time * 0.01f;
 				sf::Vector2f myPos = this->getDrawablePtr()->getPosition();
-				sf::Vector2f blastPos = blast->spritePtr()->getPosition();
-				sf::IntRect blastSize = blast->spritePtr()->getTextureRect();
+				sf::Vector2f blastPos = blast->getSprite()->getPosition();
+				sf::IntRect blastSize = blast->getSprite()->getTextureRect();
 				float dx = myPos.x - blastPos.x;
 				float dy = myPos.y - blastPos.y;
 				float distance = sqrt(dx * dx + dy * dy);
@@ -435,7 +436,7 @@ public:
 					size_t randIndex = rand() % spawnPositions.size();
 					sf::Vector2f position = spawnPositions[randIndex];
 					potionPtr = new AntiMagePotion();
-					potionPtr->spritePtr()->setPosition(position);
+					potionPtr->getSprite()->setPosition(position);
 					this->screen->add(potionPtr);
 				}
 				float missingHealthBonus = DifficultySettings::Player::missingHealthHealBonus;
@@ -0,0 +1,62 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine
+{
+	bool MappedFile::open(const std::string& filename)
+	{
+		this->close();
+		#ifdef _WIN32
+		HANDLE fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE) { return false; }
+		this->file = fileHandle;
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) { this->close(); return false; }
+		this->mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (this->mapping == nullptr) { this->close(); return false; }
+		this->bytes = static_cast<const uint8_t*>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+		if (this->bytes == nullptr) { this->close(); return false; }
+		this->length = static_cast<size_t>(fileSize.QuadPart);
+		#else
+		int fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd < 0) { return false; }
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0) { ::close(fd); return false; }
+		void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (address == MAP_FAILED) { return false; }
+		this->bytes = static_cast<const uint8_t*>(address);
+		this->length = static_cast<size_t>(info.st_size);
+		#endif
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		#ifdef _WIN32
+		if (this->bytes != nullptr) { UnmapViewOfFile(this->bytes); }
+		if (this->mapping != nullptr) { CloseHandle(this->mapping); }
+		if (this->file != nullptr) { CloseHandle(this->file); }
+		this->mapping = nullptr;
+		this->file = nullptr;
+		#else
+		if (this->bytes != nullptr) { munmap(const_cast<uint8_t*>(this->bytes), this->length); }
+		#endif
+		this->bytes = nullptr;
+		this->length = 0;
+	}
+}
@@ -0,0 +1,48 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Engine
+{
+	//maps a whole file read only into memory, the contents stay valid until close() or destruction
+	//the platform calls live in MappedFile.cpp so this header, which most of the engine includes, pulls in no system headers
+	class MappedFile
+	{
+	public:
+		MappedFile() { }
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile() { this->close(); }
+
+		bool open(const std::string& filename);
+		void close();
+
+		const uint8_t* data() const
+		{
+			return this->bytes;
+		}
+
+		size_t size() const
+		{
+			return this->length;
+		}
+
+		bool isOpen() const
+		{
+			return this->bytes != nullptr;
+		}
+
+	private:
+		const uint8_t* bytes = nullptr;
+		size_t length = 0;
+		#ifdef _WIN32
+		void* file = nullptr; //the file's HANDLE, nullptr rather than INVALID_HANDLE_VALUE while closed
+		void* mapping = nullptr;
+		#endif
+	};
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include "Tutorial.h"
 #include "FileLoadException.h"
 #include "ResourceManager.h"
+#include "AssetLoader.h"
 #include "SpriteFactory.h"
 #include <functional>
 #include <cstdint>
@@ -15,12 +16,34 @@ private:
 	sf::Clock clock;
 	bool ready = false;
 	bool decline = false;
-	sf::Text* textPtr() { return dynamic_cast<sf::Text*>(this->graphic); }
+	const ResourcePreloader* levelPreloader;
+	ResourceHandle<sf::Font> font;
+	sf::Text* textPtr() { return this->getText(); }
+
+	//keeps the message up for at least 1.5 seconds, and longer if the level is still loading, with a bar showing the bytes loaded so far
+	void holdMessage(sf::RenderWindow& win)
+	{
+		sf::RectangleShape bar;
+		bar.setPosition(static_cast<float>(Screen::windowWidth) * 0.05f, static_cast<float>(Screen::windowHeight) * 0.9f);
+		bar.setFillColor({ 179, 45, 0 });
+		do
+		{
+			AssetLoader::finishLoads();
+			bar.setSize({ static_cast<float>(Screen::windowWidth) * 0.9f * this->levelPreloader->getProgress(), 10.f });
+			win.clear();
+			win.draw(this->background);
+			win.draw(*this->textPtr());
+			if (!this->levelPreloader->isDone()) { win.draw(bar); }
+			win.display();
+			sf::sleep(sf::milliseconds(10));
+		} while (this->clock.getElapsedTime().asSeconds() < 1.5f || !this->levelPreloader->isDone());
+	}
 public:
 	PlayerNameEntry() : GraphicalGameObject(sf::Text()), background(SpriteFactory::generateSprite(Sprite::ID::Bloodyhands))
 	{
-		sf::Font* fontPtr = ResourceManager<sf::Font>::GetResource("Lycanthrope.ttf");
-		this->textPtr()->setFont(*fontPtr);
+		this->subscribeEvents(TextEvents);
+		this->font = ResourceManager<sf::Font>::AcquireResource("Lycanthrope.ttf");
+		this->textPtr()->setFont(*this->font);
 		this->textPtr()->setStyle(sf::Text::Bold);
 		this->textPtr()->setFillColor({ 179, 45, 0 });
 		this->textPtr()->setCharacterSize(50U);
@@ -35,6 +58,7 @@ public:
 			this->textPtr()->setString("Oops, you've entered a secret base\n created by your family, but the \nguardian requires a password:\n");
 		}
 		this->background.setPosition(600.f, 400.f);
+		this->levelPreloader = &TestLevel::preload();
 		for (auto obj : Menu::getCurrentMenu()->getMenuObjects()) { if (obj != this) { obj->disableEvents(); } }
 	}
 
@@ -51,11 +75,7 @@ public:
 		Music::ID music;
 		if (this->ready && DifficultySettings::currentDifficulty != DifficultySettings::DIFFICULTY::TEST)
 		{
-			win.display();
-			do
-			{
-				;
-			} while (this->clock.getElapsedTime().asSeconds() < 1.5f); // pause the 'good luck' msg for some time before the real game start
+			this->holdMessage(win); // pause the 'good luck' msg for some time before the real game start
 			{
 				switch (DifficultySettings::currentDifficulty)
 				{
@@ -80,11 +100,7 @@ public:
 		if (this->ready && DifficultySettings::currentDifficulty == DifficultySettings::DIFFICULTY::TEST)
 		{
 			music = Music::ID::TestMode;
-			win.display();
-			do
-			{
-				;
-			} while (this->clock.getElapsedTime().asSeconds() < 1.5f);
+			this->holdMessage(win);
 			MusicPlayer::play(music);
 			this->screen->remove(this);
 			Menu::getCurrentMenu()->startTestLevel(this->name);
@@ -148,20 +164,20 @@ public:
 class MenuButton : public GraphicalGameObject
 {
 private:
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->getGraphic()); }
 	std::function<void()> clickFunction;
 public:
 	MenuButton(Sprite::ID spriteID, sf::Vector2f position, std::function<void()> clickFunction) : GraphicalGameObject(SpriteFactory::generateSprite(spriteID))
 	{
-		this->spritePtr()->setColor({ 255, 255, 255, 0 });
-		this->spritePtr()->setPosition(position);
+		this->subscribeEvents(MouseButtonEvents);
+		this->getSprite()->setColor({ 255, 255, 255, 0 });
+		this->getSprite()->setPosition(position);
 		this->clickFunction = clickFunction;
 	}
 
 	void MouseButtonReleased(sf::Event e)
 	{
 		if (e.mouseButton.button == sf::Mouse::Button::Left
-			&& this->spritePtr()->getGlobalBounds().contains(static_cast<float>(e.mouseButton.x), static_cast<float>(e.mouseButton.y)))
+			&& this->getSprite()->getGlobalBounds().contains(static_cast<float>(e.mouseButton.x), static_cast<float>(e.mouseButton.y)))
 		{
 			SoundPlayer::play(SoundEffect::ID::MenuClick, 20.f);
 			this->clickFunction();
@@ -179,7 +195,6 @@ private:
 	bool enabled = true;
 	bool enterPressed = false;
 	sf::Color color;
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->getGraphic()); }
 public:
 	TestModeButton() : MenuButton(Sprite::ID::Guardian, { 320.f, 160.f }, [&]()
 		{
@@ -189,6 +204,7 @@ public:
 		}),
 		SpriteSheet(3)
 	{
+		this->subscribeEvents(KeyEvents);
 		/*
 		this->textureSize = this->spritePtr()->getTexture()->getSize();
 		this->textureSize.x /= 3;
@@ -217,7 +233,7 @@ public:
 			if (this->enterPressed && this->enabled)
 			{
 				this->activated = true;
-				this->spritePtr()->setColor(this->color);
+				this->getSprite()->setColor(this->color);
 			}
 		}
 	}
@@ -226,7 +242,7 @@ public:
 	{
 		if (!this->enabled || !this->activated) { return; }
 		if (e.mouseButton.button == sf::Mouse::Button::Left
-			&& this->spritePtr()->getGlobalBounds().contains(static_cast<float>(e.mouseButton.x), static_cast<float>(e.mouseButton.y)))
+			&& this->getSprite()->getGlobalBounds().contains(static_cast<float>(e.mouseButton.x), static_cast<float>(e.mouseButton.y)))
 		{
 			DifficultySettings::setDifficulty(DifficultySettings::DIFFICULTY::TEST);
 			SoundPlayer::play(SoundEffect::ID::MenuClick, 20.f);
@@ -248,19 +264,20 @@ public:
 class MenuBackground : public GraphicalGameObject
 {
 private:
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->getGraphic()); }
+	ResourceHandle<sf::Texture> texture; //the background is not in the atlas, its texture can be evicted once the menu is gone
 public:
-	MenuBackground() : GraphicalGameObject(SpriteFactory::generateSprite(Sprite::ID::MenuBackground))
+	MenuBackground() : GraphicalGameObject(sf::Sprite())
 	{
-		this->spritePtr()->setColor({ 255, 255, 255, 0 });
+		*this->getSprite() = SpriteFactory::generateSprite(Sprite::ID::MenuBackground, this->texture);
+		this->getSprite()->setColor({ 255, 255, 255, 0 });
 	}
 
 	void AddedToScreen()
 	{
 		this->screen->schedule([&]() {
-			sf::Color color = this->spritePtr()->getColor();
+			sf::Color color = this->getSprite()->getColor();
 			color.a += 3;
-			this->spritePtr()->setColor(color);
+			this->getSprite()->setColor(color);
 		}, TimeUnit::Frames(1), 84);
 	}
 };
@@ -268,7 +285,6 @@ public:
 class EasyLevelButton : public MenuButton
 {
 private:
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->getGraphic()); }
 public:
 	EasyLevelButton() : MenuButton(Sprite::ID::MenuEasy, { 430.f, 190.f }, [&]()
 	{
@@ -279,9 +295,9 @@ public:
 	void AddedToScreen()
 	{
 		this->screen->schedule([&]() {
-			sf::Color color = this->spritePtr()->getColor();
+			sf::Color color = this->getSprite()->getColor();
 			color.a += 3;
-			this->spritePtr()->setColor(color);
+			this->getSprite()->setColor(color);
 		}, TimeUnit::Frames(1), 84);
 	}
 };
@@ -289,7 +305,6 @@ public:
 class NormalLevelButton : public MenuButton
 {
 private:
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->getGraphic()); }
 public:
 	NormalLevelButton() : MenuButton(Sprite::ID::MenuNormal, { 390.f, 265.f }, [&]()
 	{
@@ -300,9 +315,9 @@ public:
 	void AddedToScreen()
 	{
 		this->screen->schedule([&]() {
-			sf::Color color = this->spritePtr()->getColor();
+			sf::Color color = this->getSprite()->getColor();
 			color.a += 3;
-			this->spritePtr()->setColor(color);
+			this->getSprite()->setColor(color);
 		}, TimeUnit::Frames(1), 84);
 	}
 };
@@ -310,7 +325,6 @@ public:
 class HardLevelButton : public MenuButton
 {
 private:
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->getGraphic()); }
 public:
 	HardLevelButton() : MenuButton(Sprite::ID::MenuInsane, { 390.f, 360.f }, [&]()
 	{
@@ -321,9 +335,9 @@ public:
 	void AddedToScreen()
 	{
 		this->screen->schedule([&]() {
-			sf::Color color = this->spritePtr()->getColor();
+			sf::Color color = this->getSprite()->getColor();
 			color.a += 3;
-			this->spritePtr()->setColor(color);
+			this->getSprite()->setColor(color);
 		}, TimeUnit::Frames(1), 84);
 	}
 };
@@ -331,7 +345,6 @@ public:
 class TutorialButton : public MenuButton
 {
 private:
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->getGraphic()); }
 public:
 	TutorialButton() : MenuButton(Sprite::ID::MenuTutorial, { 340.f, 450.f }, [&]()
 	{
@@ -342,9 +355,9 @@ public:
 	void AddedToScreen()
 	{
 		this->screen->schedule([&]() {
-			sf::Color color = this->spritePtr()->getColor();
+			sf::Color color = this->getSprite()->getColor();
 			color.a += 3;
-			this->spritePtr()->setColor(color);
+			this->getSprite()->setColor(color);
 		}, TimeUnit::Frames(1), 84);
 	}
 };
@@ -352,7 +365,6 @@ public:
 class ScoreboardButton : public MenuButton
 {
 private:
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->getGraphic()); }
 public:
 	ScoreboardButton() : MenuButton(Sprite::ID::MenuScore, { 410.f, 540.f }, [&]()
 	{
@@ -363,9 +375,9 @@ public:
 	void AddedToScreen()
 	{
 		this->screen->schedule([&]() {
-			sf::Color color = this->spritePtr()->getColor();
+			sf::Color color = this->getSprite()->getColor();
 			color.a += 3;
-			this->spritePtr()->setColor(color);
+			this->getSprite()->setColor(color);
 		}, TimeUnit::Frames(1), 84);
 	}
 };
@@ -373,7 +385,6 @@ public:
 class QuitButton : public MenuButton
 {
 private:
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->getGraphic()); }
 public:
 	QuitButton() : MenuButton(Sprite::ID::MenuEscape, { 390.f, 630.f }, [&]()
 	{
@@ -384,24 +395,27 @@ public:
 	void AddedToScreen()
 	{
 		this->screen->schedule([&]() {
-			sf::Color color = this->spritePtr()->getColor();
+			sf::Color color = this->getSprite()->getColor();
 			color.a += 3;
-			this->spritePtr()->setColor(color);
+			this->getSprite()->setColor(color);
 		}, TimeUnit::Frames(1), 84);
 	}
 };
 
+//the bar follows the bytes the preloader has loaded, which load on the loader threads while frames keep drawing
+//the actions run once everything is in memory, so building the menu objects never waits on a file
+//the first sprite they generate still packs the decoded atlas images into pages and uploads them, which takes one frame
 class Loader : public GraphicalGameObject
 {
 public:
-	Loader(bool show, std::vector<function<void()>> loadingActions) : GraphicalGameObject(sf::RectangleShape())
+	Loader(bool show, const ResourcePreloader* preloader, std::vector<function<void()>> loadingActions) : GraphicalGameObject(sf::RectangleShape())
 	{
 		sf::RectangleShape* rect = this->rectPtr();
 		rect->setPosition(static_cast<float>(Screen::windowWidth) * 0.05f, static_cast<float>(Screen::windowHeight) * 0.5f);
 		rect->setSize({ 0.f , 10.f });
 		rect->setFillColor({ 9, 67, 8, (show ? static_cast<uint8_t>(255) : static_cast<uint8_t>(0)) });
-		size_t numActions = loadingActions.size();
-		this->barIncrement = (static_cast<float>(Screen::windowWidth) * 0.9f) / static_cast<float>(numActions);
+		this->barWidth = static_cast<float>(Screen::windowWidth) * 0.9f;
+		this->preloader = preloader;
 		this->loadingActions = loadingActions;
 		this->finishedLoading = false;
 	}
@@ -410,16 +424,14 @@ public:
 	{
 		if (!this->finishedLoading)
 		{
-			for (auto action : this->loadingActions)
+			this->rectPtr()->setSize({ this->barWidth * this->preloader->getProgress(), 10.f });
+			if (!this->preloader->isDone())
 			{
-				action();
-				sf::Vector2f size = this->rectPtr()->getSize();
-				size.x += this->barIncrement;
-				this->rectPtr()->setSize(size);
-				win.clear();
 				win.draw(*this->graphic);
-				win.display();
+				return;
 			}
+			this->preloader->wait(); //throws if a file failed to load
+			for (auto action : this->loadingActions) { action(); }
 			this->finishedLoading = true;
 			this->screen->schedule([&]() {
 				sf::Color color = this->rectPtr()->getFillColor();
@@ -435,8 +447,9 @@ public:
 
 private:
 	std::vector<function<void()>> loadingActions;
-	sf::RectangleShape* rectPtr() { return dynamic_cast<sf::RectangleShape*>(this->graphic); }
-	float barIncrement;
+	const ResourcePreloader* preloader;
+	sf::RectangleShape* rectPtr() { return this->getRectangleShape(); }
+	float barWidth;
 	bool finishedLoading;
 };
 
@@ -445,9 +458,12 @@ namespace Engine
 	Menu::Menu(bool showLoadingBar)
 	{
 		currentMenu = this;
-		Loader* loader = new Loader(showLoadingBar, {
+		SoundPlayer::preloadSounds(this->preloader);
+		SpriteFactory::preloadAtlas(this->preloader);
+		SpriteFactory::preload(Sprite::ID::MenuBackground, this->preloader);
+		for (const char* font : { "Lycanthrope.ttf", "harting.ttf" }) { this->preloader.add<sf::Font>(font); }
+		Loader* loader = new Loader(showLoadingBar, &this->preloader, {
 			[]() { MusicPlayer::play(Music::ID::Menu); },
-			[]() { SoundPlayer::preloadSounds(); },
 			[&]() { this->menuObjects.push_back(new MenuBackground()); },
 			[&]() { this->menuObjects.push_back(new EasyLevelButton()); },
 			[&]() { this->menuObjects.push_back(new NormalLevelButton()); },
@@ -3,6 +3,7 @@
 
 #include "Screen.h"
 #include "TestLevel.h"
+#include "ResourcePreloader.h"
 #include "DifficultySettings.h"
 #include <vector>
 #include <string>
@@ -17,6 +18,7 @@ namespace Engine
 		std::vector<GameObject*> menuObjects;
 		Screen menuScreen;
 		TestLevel testLevel;
+		ResourcePreloader preloader;
 	public:
 		Menu(bool showLoadingBar = false);
 		~Menu();
@@ -11,23 +11,25 @@ using std::function;
 
 static sf::Music* musicPtr = nullptr;
 
-void MusicPlayer::play(string musicFileName, float volume)
+void MusicPlayer::play(const string& musicFileName, float volume)
 {
-	stop();
-	MusicWrapper* wrapper = ResourceManager<MusicWrapper>::GetResource(musicFileName);
-	musicPtr = &(wrapper->music);
-	musicPtr->setVolume(volume);
-	musicPtr->setLoop(true);
-	musicPtr->play();		
+	play(ResourceManager<MusicWrapper>::GetResource(musicFileName), volume);
 }
 
 void MusicPlayer::play(Music::ID theme, float volume)
 {
 	InitializeIDMap();
-	map<Music::ID, std::string>& musicIDMap = getMusicIDMap();
-	auto iter = musicIDMap.find(theme);
-	if (iter == musicIDMap.end()) { return; }
-	play((*iter).second, volume);
+	if (static_cast<size_t>(theme) >= themeCount) { return; }
+	play(ResourceManager<MusicWrapper>::GetResource(getMusicKeys()[static_cast<size_t>(theme)]), volume);
+}
+
+void MusicPlayer::play(MusicWrapper* wrapper, float volume)
+{
+	stop();
+	musicPtr = &(wrapper->music);
+	musicPtr->setVolume(volume);
+	musicPtr->setLoop(true);
+	musicPtr->play();		
 }
 
 void MusicPlayer::stop()
@@ -5,6 +5,7 @@
 #include "FileLoadException.h"
 #include "ResourceManager.h"
 #include <map>
+#include <array>
 #include <string>
 #include <functional>
 
@@ -21,7 +22,8 @@ namespace Music
 		EasyGame,
 		NormalGame,
 		HardGame,
-		GameOver
+		GameOver,
+		Count //number of ids, not a theme
 	};
 }
 
@@ -33,38 +35,50 @@ public:
 	{
 		return music.openFromFile(filename);
 	}
+	//music streams from the data while it plays, which stays valid because the archive is never unmapped while the game runs
+	bool loadFromMemory(const void* data, size_t size)
+	{
+		return music.openFromMemory(data, size);
+	}
 };
 
 class MusicPlayer : private sf::NonCopyable
 {
 private:
 
-	static map<Music::ID, std::string>& getMusicIDMap()
+	static constexpr size_t themeCount = static_cast<size_t>(Music::ID::Count);
+
+	//the interned key of each theme's file, indexed by id
+	static std::array<ResourceManager<MusicWrapper>::Key, themeCount>& getMusicKeys()
 	{
-		static map<Music::ID, std::string> musicIDMap;
-		return musicIDMap;
+		static std::array<ResourceManager<MusicWrapper>::Key, themeCount> musicKeys;
+		return musicKeys;
 	}
 
 	static void InitializeIDMap()
 	{
 		static bool initialized = false;
 		if (initialized) { return; }
-		map<Music::ID, std::string>& musicIDMap = getMusicIDMap();
-		musicIDMap[Music::ID::Menu] = "theme_menu.ogg";
-		musicIDMap[Music::ID::TestMode] = "theme_test.ogg";
-		musicIDMap[Music::ID::EasyGame] = "theme_easy.ogg";
-		musicIDMap[Music::ID::NormalGame] = "theme_normal.ogg";
-		musicIDMap[Music::ID::HardGame] = "theme_hard.ogg";
-		musicIDMap[Music::ID::GameOver] = "theme_gameover.ogg";
+		std::array<std::string, themeCount> musicIDMap;
+		musicIDMap[static_cast<size_t>(Music::ID::Menu)] = "theme_menu.ogg";
+		musicIDMap[static_cast<size_t>(Music::ID::TestMode)] = "theme_test.ogg";
+		musicIDMap[static_cast<size_t>(Music::ID::EasyGame)] = "theme_easy.ogg";
+		musicIDMap[static_cast<size_t>(Music::ID::NormalGame)] = "theme_normal.ogg";
+		musicIDMap[static_cast<size_t>(Music::ID::HardGame)] = "theme_hard.ogg";
+		musicIDMap[static_cast<size_t>(Music::ID::GameOver)] = "theme_gameover.ogg";
+		for (size_t i = 0; i < themeCount; i++) { getMusicKeys()[i] = ResourceManager<MusicWrapper>::Intern(musicIDMap[i]); }
 		initialized = true;
 	}
 
 public:	
-	static void play(string musicFileName, float volume = 20.f);
+	static void play(const string& musicFileName, float volume = 20.f);
 	static void play(Music::ID theme, float volume = 20.f);
 	static void stop();	
 	static void setPaused(bool paused);
 	static void setVolume(float volume);
+
+private:
+	static void play(MusicWrapper* wrapper, float volume);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Engine
+{
+	//recycles objects that leave the screen instead of deleting them, so a steady stream of short lived objects stops allocating
+	//T needs a reset method taking its constructor's arguments which puts a reused object back in the state the constructor would
+	//Screen never deletes a pooled object it removes, the object gives itself back with release from RemovedFromScreen
+	template<typename T> class ObjectPool
+	{
+	public:
+		ObjectPool() { }
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		~ObjectPool()
+		{
+			for (T* object : this->available) { delete object; }
+		}
+
+		//a released object if there is one, otherwise a new one
+		template<typename... Args> T* acquire(Args&&... args)
+		{
+			if (this->available.empty())
+			{
+				this->allocations++;
+				T* object = new T(std::forward<Args>(args)...);
+				object->pooled = true;
+				return object;
+			}
+			T* object = this->available.back();
+			this->available.pop_back();
+			object->renewID();
+			object->reset(std::forward<Args>(args)...);
+			this->reuses++;
+			return object;
+		}
+
+		//the object must not be on a screen, the pool owns it until it is acquired again
+		void release(T* object)
+		{
+			this->available.push_back(object);
+		}
+
+		std::size_t getAvailableCount() const
+		{
+			return this->available.size();
+		}
+
+		uint64_t getAllocationCount() const
+		{
+			return this->allocations;
+		}
+
+		uint64_t getReuseCount() const
+		{
+			return this->reuses;
+		}
+
+	private:
+		std::vector<T*> available;
+		uint64_t allocations = 0;
+		uint64_t reuses = 0;
+	};
+}
+
+#endif
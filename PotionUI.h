@@ -12,14 +12,14 @@ class PotionUI : public GraphicalGameObject
 {
 private:
 	MainCharacter* character = nullptr;
+	ResourceHandle<sf::Font> font;
 	sf::Text text;
-	sf::Sprite* spritePtr() { return dynamic_cast<sf::Sprite*>(this->getGraphic()); }
 public:
 	PotionUI(sf::Sprite s) : GraphicalGameObject(s)
 	{
-		this->spritePtr()->setPosition(50.f, 70.f);
-		sf::Font* font = ResourceManager<sf::Font>::GetResource("zombie.ttf");
-		this->text.setFont(*font);
+		this->getSprite()->setPosition(50.f, 70.f);
+		this->font = ResourceManager<sf::Font>::AcquireResource("zombie.ttf");
+		this->text.setFont(*this->font);
 		this->text.setStyle(sf::Text::Bold);
 		this->text.setLetterSpacing(3.f);
 		this->text.setOutlineColor({ 163, 19, 88 });
@@ -40,8 +40,8 @@ public:
 
 	void draw(sf::RenderWindow& win)
 	{
-		win.draw(*this->spritePtr());
-		this->text.setPosition(this->spritePtr()->getPosition().x + 50, this->spritePtr()->getPosition().y - 5);
+		win.draw(*this->getSprite());
+		this->text.setPosition(this->getSprite()->getPosition().x + 50, this->getSprite()->getPosition().y - 5);
 		win.draw(this->text);
 	}
 };
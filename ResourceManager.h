@@ -3,12 +3,21 @@
 
 #include <iostream>
 #include <string>
+#include <memory>
 #include <unordered_map>
 #include <queue>
+#include <list>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cstdint>
 #include "SFML/Graphics.hpp"
 #include "SFML/Audio.hpp"
 #include "FileLoadException.h"
 #include "DebugManager.h"
+#include "AssetLoader.h"
+#include "AssetArchive.h"
 
 using std::string;
 using std::unordered_map;
@@ -18,53 +27,259 @@ using std::endl;
 
 namespace Engine
 {
+	//how a resource is loaded: decode may run on a loader thread, upload always runs on the main thread
+	//most resources are loaded completely by decode, Staged holds whatever decode produces for upload to finish
+	//filename is relative to data/, decode reads it from the mounted AssetArchive when there is one
+	//bytesUsed is what the resource counts against its cache's memory budget
+	template<typename T> struct ResourceLoader
+	{
+		struct Staged {};
+		static constexpr const char* typeName = "Resource";
+		static bool decode(const string& filename, T& resource, Staged& staged) { return AssetArchive::loadResource(filename, resource); }
+		static bool upload(T& resource, Staged& staged) { return true; }
+		//types that do not say how much memory they hold count the size of their file
+		static size_t bytesUsed(const T& resource, const string& filename) { return static_cast<size_t>(AssetArchive::fileSize(filename)); }
+	};
+
+	//textures are decoded to an image off the main thread, only the upload to the graphics card happens on it
+	template<> struct ResourceLoader<sf::Texture>
+	{
+		struct Staged { sf::Image image; };
+		static constexpr const char* typeName = "Texture";
+		static bool decode(const string& filename, sf::Texture& texture, Staged& staged) { return AssetArchive::loadResource(filename, staged.image); }
+		static bool upload(sf::Texture& texture, Staged& staged) { return texture.loadFromImage(staged.image); }
+		static size_t bytesUsed(const sf::Texture& texture, const string& filename) { return static_cast<size_t>(texture.getSize().x) * texture.getSize().y * 4; }
+	};
+
+	template<> struct ResourceLoader<sf::SoundBuffer>
+	{
+		struct Staged {};
+		static constexpr const char* typeName = "Sound buffer";
+		static bool decode(const string& filename, sf::SoundBuffer& buffer, Staged& staged) { return AssetArchive::loadResource(filename, buffer); }
+		static bool upload(sf::SoundBuffer& buffer, Staged& staged) { return true; }
+		static size_t bytesUsed(const sf::SoundBuffer& buffer, const string& filename) { return static_cast<size_t>(buffer.getSampleCount()) * sizeof(sf::Int16); }
+	};
+
+	template<typename T> class ResourceManager;
+
+	//a cached resource and its bookkeeping, map nodes never move so handles can point straight at one
+	template<typename T> struct ResourceCacheEntry
+	{
+		T* resource = nullptr;
+		size_t bytes = 0;
+		uint32_t references = 0; //live ResourceHandles
+		bool pinned = false; //handed out as a raw pointer by GetResource, which has no way to give it back
+		bool unloadWhenReleased = false; //UnloadResource was called while handles still used it
+		uint32_t key = UINT32_MAX; //the interned key for the filename, UINT32_MAX if there is none
+		std::pair<const string, ResourceCacheEntry>* node = nullptr; //the map node holding this entry
+		typename std::list<ResourceCacheEntry*>::iterator recentUse; //position in the least recently used order
+	};
+
+	//keeps a cached resource from being evicted for as long as a copy of the handle exists
+	template<typename T> class ResourceHandle
+	{
+	public:
+		ResourceHandle() {}
+		ResourceHandle(const ResourceHandle& other) : entry(other.entry) { if (this->entry) { this->entry->references++; } }
+		ResourceHandle& operator=(ResourceHandle other)
+		{
+			std::swap(this->entry, other.entry);
+			return *this;
+		}
+		~ResourceHandle() { if (this->entry) { ResourceManager<T>::releaseEntry(this->entry); } }
+
+		T* get() const { return (this->entry) ? this->entry->resource : nullptr; }
+		T& operator*() const { return *this->entry->resource; }
+		T* operator->() const { return this->entry->resource; }
+		explicit operator bool() const { return this->entry != nullptr; }
+
+	private:
+		friend class ResourceManager<T>;
+		explicit ResourceHandle(ResourceCacheEntry<T>* entry) : entry(entry) { this->entry->references++; }
+		ResourceCacheEntry<T>* entry = nullptr;
+	};
+
+	//a resource being loaded in the background, copies share the same load
+	template<typename T> class ResourceRequest
+	{
+	public:
+		ResourceRequest() {}
+
+		const string& getFilename() const { return this->state->filename; }
+
+		//true once the resource can be used without waiting, loads that failed are ready too and throw from get
+		bool isReady() const { return this->state == nullptr || this->state->finished; }
+
+		//waits for the load if it is still running
+		//once loaded the resource stays cached for as long as a copy of the request exists, like it does for a ResourceHandle
+		T* get() const
+		{
+			if (this->state == nullptr) { return nullptr; }
+			if (!this->state->finished) { AssetLoader::wait(this->state->ticket); }
+			if (!this->state->handle) { throw GameException::DataFileLoadException(this->state->filename); }
+			return this->state->handle.get();
+		}
+
+	private:
+		friend class ResourceManager<T>;
+		struct State
+		{
+			string filename;
+			T* resource = nullptr; //owned by the request until the load finishes
+			ResourceHandle<T> handle; //empty until the load finishes, and after a failed load
+			typename ResourceLoader<T>::Staged staged;
+			bool decoded = false;
+			bool finished = false;
+			AssetLoader::Ticket ticket;
+		};
+		std::shared_ptr<State> state;
+	};
+
+	//each resource type has its own cache, byte count and optional memory budget
+	//once the budget is exceeded the least recently used resources that nothing references are deleted
+	//resources from GetResource are never evicted, the others are kept only while a ResourceHandle or ResourceRequest uses them
 	template<typename T> class ResourceManager
 	{
 	public:
+		//stands for a filename, a lookup by key indexes an array instead of hashing or building any string
+		typedef uint32_t Key;
+
 		ResourceManager() = delete;
-		static T* GetResource(string filename)
+		//pinning cancels an unload still waiting on handles, the pointer returned here has no way to be given back
+		static T* GetResource(const string& filename)
 		{
-			unordered_map<string, T*>& resourceCache = getResourceCache();
-			auto iter = resourceCache.find(filename);
-			if (iter != resourceCache.end())
+			ResourceCacheEntry<T>* entry = findEntry(filename);
+			if (entry == nullptr) { entry = loadEntry(filename); }
+			entry->pinned = true;
+			entry->unloadWhenReleased = false;
+			return entry->resource;
+		}
+
+		static T* GetResource(Key key)
+		{
+			ResourceCacheEntry<T>* entry = findEntry(key);
+			if (entry == nullptr) { entry = loadEntry(getKeys().names[key]); }
+			entry->pinned = true;
+			entry->unloadWhenReleased = false;
+			return entry->resource;
+		}
+
+		//like GetResource, but the resource can be evicted again once every copy of the handle is gone
+		static ResourceHandle<T> AcquireResource(const string& filename)
+		{
+			ResourceCacheEntry<T>* entry = findEntry(filename);
+			if (entry == nullptr) { entry = loadEntry(filename); }
+			return ResourceHandle<T>(entry);
+		}
+
+		static ResourceHandle<T> AcquireResource(Key key)
+		{
+			ResourceCacheEntry<T>* entry = findEntry(key);
+			if (entry == nullptr) { entry = loadEntry(getKeys().names[key]); }
+			return ResourceHandle<T>(entry);
+		}
+
+		//returns the filename's key, the same one every time, interning is meant for startup and looks the name up by string
+		static Key Intern(const string& filename)
+		{
+			Keys& keys = getKeys();
+			auto iter = keys.byName.find(filename);
+			if (iter != keys.byName.end()) { return (*iter).second; }
+			Key key = static_cast<Key>(keys.names.size());
+			keys.byName[filename] = key;
+			keys.names.push_back(filename);
+			keys.entries.push_back(nullptr);
+			//a resource cached before its name was interned is linked to the new key
+			auto cached = getResourceCache().find(filename);
+			if (cached != getResourceCache().end())
 			{
-				DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string("Resource \"") + filename + string("\" found in cache."));
-				return (*iter).second;
+				(*cached).second.key = key;
+				keys.entries[key] = &(*cached).second;
 			}
-			else { DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string("Resource \"") + filename + string("\" not found in cache. Loading from file.")); }
-			T* resourcePtr = new T();
-			if (!resourcePtr->loadFromFile(string("data/") + filename)) { throw GameException::DataFileLoadException(filename); }
-			resourceCache[filename] = resourcePtr;
-			DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string("Resource \"") + filename + string("\" loaded successfully."));
-			return resourcePtr;
+			return key;
 		}
 
+		static const string& GetFilename(Key key)
+		{
+			return getKeys().names[key];
+		}
+
+		//starts loading the resource on a loader thread and returns at once, GetResource on the same file afterwards only waits for that load
+		//the resource reaches the cache when Screen next finishes loads or when the request is waited on
+		static ResourceRequest<T> RequestResource(string filename)
+		{
+			ResourceRequest<T> request;
+			if (ResourceCacheEntry<T>* entry = findEntry(filename))
+			{
+				request.state = std::make_shared<typename ResourceRequest<T>::State>();
+				request.state->filename = filename;
+				request.state->handle = ResourceHandle<T>(entry);
+				request.state->finished = true;
+				return request;
+			}
+			unordered_map<string, ResourceRequest<T>>& pendingRequests = getPendingRequests();
+			auto pending = pendingRequests.find(filename);
+			if (pending != pendingRequests.end()) { return (*pending).second; }
+
+			DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string("Resource \"") + filename + string("\" requested. Loading in the background."));
+			auto state = std::make_shared<typename ResourceRequest<T>::State>();
+			state->filename = filename;
+			state->resource = new T();
+			request.state = state;
+			pendingRequests[filename] = request;
+			state->ticket = AssetLoader::submit(
+				[state]() { state->decoded = ResourceLoader<T>::decode(state->filename, *state->resource, state->staged); },
+				[state]() { finishRequest(*state); });
+			return request;
+		}
+
+		//loads the file again into the cached resource itself, so pointers from GetResource and live handles all see the new contents
+		//a cached resource keeps whatever pin or pending unload it had, one that is not cached yet is loaded and pinned by GetResource
 		static T* ReloadResource(string filename)
 		{
-			UnloadResource(filename);
-			return GetResource(filename);
+			unordered_map<string, ResourceCacheEntry<T>>& resourceCache = getResourceCache();
+			auto iter = resourceCache.find(filename);
+			if (iter == resourceCache.end()) { return GetResource(filename); }
+			ResourceCacheEntry<T>& entry = (*iter).second;
+			T reloaded;
+			typename ResourceLoader<T>::Staged staged;
+			if (!ResourceLoader<T>::decode(filename, reloaded, staged) || !ResourceLoader<T>::upload(reloaded, staged))
+			{
+				throw GameException::DataFileLoadException(filename);
+			}
+			*entry.resource = reloaded;
+			Statistics& stats = getStatistics();
+			stats.bytes -= entry.bytes;
+			entry.bytes = ResourceLoader<T>::bytesUsed(*entry.resource, filename);
+			stats.bytes += entry.bytes;
+			DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string("Resource \"") + filename + string("\" reloaded."));
+			return entry.resource;
 		}
 
+		//deletes the resource, pointers from GetResource become invalid
+		//a resource that handles still use is deleted when the last of them is released instead, unless GetResource pins it again first
 		static void UnloadResource(string filename)
 		{
-			unordered_map<string, T*> resourceCache = getResourceCache();
+			unordered_map<string, ResourceCacheEntry<T>>& resourceCache = getResourceCache();
 			auto iter = resourceCache.find(filename);
 			if (iter == resourceCache.end()) { return; }
-			T* ptr = (*iter).second;
-			resourceCache.erase(iter);
-			delete ptr;
-			ptr = nullptr;
+			ResourceCacheEntry<T>& entry = (*iter).second;
+			if (entry.references > 0)
+			{
+				entry.unloadWhenReleased = true;
+				return;
+			}
+			eraseEntry(entry);
 		}
 
 		static void ReloadAllResources()
 		{
-			unordered_map<string, T*>& resourceCache = getResourceCache();
+			unordered_map<string, ResourceCacheEntry<T>>& resourceCache = getResourceCache();
 			queue<string> reloadQueue;
-			for (auto pair : resourceCache)
+			for (auto const & pair : resourceCache)
 			{
 				reloadQueue.push(pair.first);
 			}
-			resourceCache.clear();
 			while (!reloadQueue.empty())
 			{
 				string filename = reloadQueue.front();
@@ -72,11 +287,214 @@ namespace Engine
 				ReloadResource(filename);
 			}
 		}
+
+		//0 means no budget, lowering it below the bytes in use evicts right away
+		static void SetMemoryBudget(size_t bytes)
+		{
+			getStatistics().budget = bytes;
+			enforceBudget(nullptr);
+		}
+
+		static size_t GetMemoryBudget()
+		{
+			return getStatistics().budget;
+		}
+
+		static size_t GetMemoryUsed()
+		{
+			return getStatistics().bytes;
+		}
+
+		static void ReportCacheStatistics()
+		{
+			const Statistics& stats = getStatistics();
+			uint64_t lookups = stats.hits + stats.misses;
+			double hitRate = (lookups > 0) ? 100.0 * static_cast<double>(stats.hits) / static_cast<double>(lookups) : 0.0;
+			DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string(ResourceLoader<T>::typeName) + string(" cache: ")
+				+ std::to_string(getResourceCache().size()) + string(" resources, ")
+				+ std::to_string(stats.bytes) + string(" bytes")
+				+ ((stats.budget > 0) ? string(" of a ") + std::to_string(stats.budget) + string(" byte budget") : string(""))
+				+ string(", hit rate ") + std::to_string(hitRate) + string("%, ")
+				+ std::to_string(stats.evictions) + string(" evicted"));
+		}
 	private:
-		static unordered_map<string, T*>& getResourceCache()
+		friend class ResourceHandle<T>;
+
+		struct Statistics
+		{
+			size_t bytes = 0;
+			size_t budget = 0;
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			uint64_t evictions = 0;
+		};
+
+		//the cache and its bookkeeping are never destroyed, so handles held by other statics can still be released at exit
+		static unordered_map<string, ResourceCacheEntry<T>>& getResourceCache()
+		{
+			static unordered_map<string, ResourceCacheEntry<T>>* resourceCache = new unordered_map<string, ResourceCacheEntry<T>>();
+			return *resourceCache;
+		}
+
+		//most recently used first
+		static std::list<ResourceCacheEntry<T>*>& getRecentUse()
+		{
+			static std::list<ResourceCacheEntry<T>*>* recentUse = new std::list<ResourceCacheEntry<T>*>();
+			return *recentUse;
+		}
+
+		struct Keys
+		{
+			unordered_map<string, Key> byName;
+			std::vector<string> names;
+			std::vector<ResourceCacheEntry<T>*> entries; //nullptr while the resource is not cached
+		};
+
+		static Keys& getKeys()
+		{
+			static Keys* keys = new Keys();
+			return *keys;
+		}
+
+		static Statistics& getStatistics()
+		{
+			static Statistics* statistics = new Statistics();
+			return *statistics;
+		}
+
+		static unordered_map<string, ResourceRequest<T>>& getPendingRequests()
+		{
+			static unordered_map<string, ResourceRequest<T>> pendingRequests;
+			return pendingRequests;
+		}
+
+		//counts a hit and marks the entry as just used, nullptr if it is not cached
+		static ResourceCacheEntry<T>* findEntry(const string& filename)
+		{
+			unordered_map<string, ResourceCacheEntry<T>>& resourceCache = getResourceCache();
+			auto iter = resourceCache.find(filename);
+			if (iter == resourceCache.end()) { return nullptr; }
+			#ifdef _DEBUG
+			DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string("Resource \"") + filename + string("\" found in cache."));
+			#endif
+			return markUsed(&(*iter).second);
+		}
+
+		static ResourceCacheEntry<T>* findEntry(Key key)
 		{
-			static unordered_map<string, T*> resourceCache;
-			return resourceCache;
+			ResourceCacheEntry<T>* entry = getKeys().entries[key];
+			return (entry != nullptr) ? markUsed(entry) : nullptr;
+		}
+
+		//counts a hit and moves the entry to the front of the recency list
+		static ResourceCacheEntry<T>* markUsed(ResourceCacheEntry<T>* entry)
+		{
+			std::list<ResourceCacheEntry<T>*>& recentUse = getRecentUse();
+			recentUse.splice(recentUse.begin(), recentUse, entry->recentUse);
+			getStatistics().hits++;
+			return entry;
+		}
+
+		//loads the resource on this thread, or finishes a background load of it that is already running
+		static ResourceCacheEntry<T>* loadEntry(const string& filename)
+		{
+			getStatistics().misses++;
+			unordered_map<string, ResourceRequest<T>>& pendingRequests = getPendingRequests();
+			auto pending = pendingRequests.find(filename);
+			if (pending != pendingRequests.end())
+			{
+				ResourceRequest<T> request = (*pending).second;
+				request.get();
+				auto iter = getResourceCache().find(filename);
+				if (iter != getResourceCache().end()) { return &(*iter).second; }
+			}
+			DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string("Resource \"") + filename + string("\" not found in cache. Loading from data."));
+			T* resourcePtr = new T();
+			typename ResourceLoader<T>::Staged staged;
+			if (!ResourceLoader<T>::decode(filename, *resourcePtr, staged) || !ResourceLoader<T>::upload(*resourcePtr, staged))
+			{
+				delete resourcePtr;
+				throw GameException::DataFileLoadException(filename);
+			}
+			DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string("Resource \"") + filename + string("\" loaded successfully."));
+			return insertEntry(filename, resourcePtr);
+		}
+
+		static ResourceCacheEntry<T>* insertEntry(const string& filename, T* resource)
+		{
+			auto inserted = getResourceCache().emplace(filename, ResourceCacheEntry<T>());
+			ResourceCacheEntry<T>& entry = (*inserted.first).second;
+			entry.resource = resource;
+			entry.bytes = ResourceLoader<T>::bytesUsed(*resource, filename);
+			entry.node = &(*inserted.first);
+			std::list<ResourceCacheEntry<T>*>& recentUse = getRecentUse();
+			recentUse.push_front(&entry);
+			entry.recentUse = recentUse.begin();
+			Keys& keys = getKeys();
+			auto key = keys.byName.find(filename);
+			if (key != keys.byName.end())
+			{
+				entry.key = (*key).second;
+				keys.entries[entry.key] = &entry;
+			}
+			getStatistics().bytes += entry.bytes;
+			enforceBudget(&entry);
+			return &entry;
+		}
+
+		static void eraseEntry(ResourceCacheEntry<T>& entry)
+		{
+			getStatistics().bytes -= entry.bytes;
+			getRecentUse().erase(entry.recentUse);
+			if (entry.key != UINT32_MAX) { getKeys().entries[entry.key] = nullptr; }
+			delete entry.resource;
+			unordered_map<string, ResourceCacheEntry<T>>& resourceCache = getResourceCache();
+			resourceCache.erase(resourceCache.find(entry.node->first));
+		}
+
+		//evicts unreferenced resources, least recently used first, until the cache fits the budget
+		//keep is never evicted, a resource that was just loaded stays even if it alone is over the budget
+		static void enforceBudget(ResourceCacheEntry<T>* keep)
+		{
+			Statistics& stats = getStatistics();
+			if (stats.budget == 0 || stats.bytes <= stats.budget) { return; }
+			std::list<ResourceCacheEntry<T>*>& recentUse = getRecentUse();
+			auto iter = recentUse.end();
+			while (stats.bytes > stats.budget && iter != recentUse.begin())
+			{
+				--iter;
+				ResourceCacheEntry<T>* entry = *iter;
+				if (entry == keep || entry->pinned || entry->references > 0) { continue; }
+				DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string("Resource \"") + entry->node->first + string("\" evicted from cache."));
+				iter = std::next(iter);
+				eraseEntry(*entry);
+				stats.evictions++;
+			}
+		}
+
+		static void releaseEntry(ResourceCacheEntry<T>* entry)
+		{
+			if (--entry->references > 0) { return; }
+			if (entry->unloadWhenReleased) { eraseEntry(*entry); }
+			else { enforceBudget(nullptr); }
+		}
+
+		//runs on the main thread once the request is decoded
+		static void finishRequest(typename ResourceRequest<T>::State& state)
+		{
+			state.finished = true;
+			getPendingRequests().erase(state.filename);
+			if (!state.decoded || !ResourceLoader<T>::upload(*state.resource, state.staged))
+			{
+				DebugManager::PrintMessage(DebugManager::MessageType::ERROR_REPORTING, string("Resource \"") + state.filename + string("\" failed to load in the background."));
+				delete state.resource;
+				state.resource = nullptr;
+				return;
+			}
+			state.staged = typename ResourceLoader<T>::Staged();
+			state.handle = ResourceHandle<T>(insertEntry(state.filename, state.resource));
+			state.resource = nullptr;
+			DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, string("Resource \"") + state.filename + string("\" loaded successfully."));
 		}
 	};
 }
@@ -0,0 +1,172 @@
+#ifndef RESOURCE_PRELOADER_H
+#define RESOURCE_PRELOADER_H
+
+#include "ResourceManager.h"
+#include "AssetLoader.h"
+#include "AssetArchive.h"
+#include "MappedFile.h"
+#include "FileLoadException.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Engine
+{
+	//starts background loads for a set of files at once and reports progress in bytes, so a loading bar moves with the data actually loaded
+	//the loads run on the AssetLoader workers in parallel, progress only changes when Screen (or wait) finishes them on the main thread
+	class ResourcePreloader
+	{
+	public:
+		//filename is relative to data/ like every ResourceManager name
+		template<typename T> void add(const std::string& filename)
+		{
+			if (this->contains(filename)) { return; }
+			ResourceRequest<T> request = ResourceManager<T>::RequestResource(filename);
+			Entry entry;
+			entry.name = filename;
+			entry.bytes = std::max<uint64_t>(AssetArchive::fileSize(filename), 1);
+			entry.isReady = [request]() { return request.isReady(); };
+			entry.wait = [request]() { request.get(); };
+			this->add(std::move(entry));
+		}
+
+		//maps are memory mapped by TileMap rather than cached, so the file is read once on a loader thread to bring it into the page cache
+		//path is the full path TileMap is given, a map in data/ that the mounted AssetArchive has is faulted in from the archive instead
+		void addMappedFile(const std::string& path)
+		{
+			if (this->contains(path)) { return; }
+			const uint8_t* archived = nullptr;
+			size_t archivedSize = 0;
+			bool inArchive = (path.compare(0, 5, "data/") == 0 && AssetArchive::findMounted(path.substr(5), archived, archivedSize));
+			auto loaded = std::make_shared<bool>(false);
+			AssetLoader::Ticket ticket = AssetLoader::submit([loaded, path, archived, archivedSize]()
+			{
+				MappedFile file;
+				const uint8_t* data = archived;
+				size_t size = archivedSize;
+				if (data == nullptr)
+				{
+					if (!file.open(path)) { return; }
+					data = file.data();
+					size = file.size();
+				}
+				//touching one byte per page is enough to fault the whole file in
+				volatile uint8_t sum = 0;
+				for (size_t offset = 0; offset < size; offset += 4096) { sum += data[offset]; }
+				*loaded = true;
+			}, []() {});
+			Entry entry;
+			entry.name = path;
+			entry.bytes = inArchive ? std::max<uint64_t>(archivedSize, 1) : fileSize(path);
+			entry.isReady = [ticket]() { return AssetLoader::isDecoded(ticket); };
+			entry.wait = [ticket, loaded, path]()
+			{
+				AssetLoader::wait(ticket);
+				if (!*loaded) { throw GameException::DataFileLoadException(path); }
+			};
+			this->add(std::move(entry));
+		}
+
+		//a job some other loader already submitted, like a texture atlas image, counted as bytes of name's file
+		//wait only waits for the job, the code using its result reports a failed load
+		void addJob(const std::string& name, AssetLoader::Ticket ticket)
+		{
+			if (this->contains(name)) { return; }
+			Entry entry;
+			entry.name = name;
+			entry.bytes = std::max<uint64_t>(AssetArchive::fileSize(name), 1);
+			entry.isReady = [ticket]() { return AssetLoader::isDecoded(ticket); };
+			entry.wait = [ticket]() { AssetLoader::wait(ticket); };
+			this->add(std::move(entry));
+		}
+
+		//forgets the files added so far, the resources they loaded stay cached
+		void clear()
+		{
+			this->entries.clear();
+			this->totalBytes = 0;
+		}
+
+		uint64_t getTotalBytes() const
+		{
+			return this->totalBytes;
+		}
+
+		uint64_t getLoadedBytes() const
+		{
+			uint64_t loaded = 0;
+			for (auto const & entry : this->entries)
+			{
+				if (entry.isReady()) { loaded += entry.bytes; }
+			}
+			return loaded;
+		}
+
+		//between 0 and 1, 1 if nothing was added
+		float getProgress() const
+		{
+			if (this->totalBytes == 0) { return 1.f; }
+			return static_cast<float>(static_cast<double>(this->getLoadedBytes()) / static_cast<double>(this->totalBytes));
+		}
+
+		bool isDone() const
+		{
+			for (auto const & entry : this->entries)
+			{
+				if (!entry.isReady()) { return false; }
+			}
+			return true;
+		}
+
+		//blocks until every file is loaded, throws GameException::DataFileLoadException for the first one that failed
+		void wait() const
+		{
+			for (auto const & entry : this->entries) { entry.wait(); }
+		}
+
+		size_t size() const
+		{
+			return this->entries.size();
+		}
+
+	private:
+		struct Entry
+		{
+			std::string name;
+			uint64_t bytes;
+			std::function<bool()> isReady;
+			std::function<void()> wait;
+		};
+
+		//files that cannot be opened count as one byte, their load fails and is reported by wait
+		static uint64_t fileSize(const std::string& path)
+		{
+			std::ifstream fin(path.c_str(), std::ios::binary | std::ios::ate);
+			std::streamoff size = fin ? static_cast<std::streamoff>(fin.tellg()) : 0;
+			return (size > 0) ? static_cast<uint64_t>(size) : 1;
+		}
+
+		bool contains(const std::string& name) const
+		{
+			for (auto const & entry : this->entries)
+			{
+				if (entry.name == name) { return true; }
+			}
+			return false;
+		}
+
+		void add(Entry entry)
+		{
+			this->totalBytes += entry.bytes;
+			this->entries.push_back(std::move(entry));
+		}
+
+		std::vector<Entry> entries;
+		uint64_t totalBytes = 0;
+	};
+}
+
+#endif
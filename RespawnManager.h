@@ -32,17 +32,22 @@ private:
 		{
 			this->cooldown = this->respawnSpeed + ((rand() % 120) - 60); //randomize respawn rate +/- 1 second
 			if (this->cooldown <= 10) { this->cooldown = 10; }
-			const TileMap* map = this->screen->getMap();
-			std::vector<sf::Vector2f> spawnPositions = map->getSafeSpawnPositions();
-			size_t randIndex = rand() % spawnPositions.size();
-			sf::Vector2f position = spawnPositions[randIndex];
-			this->sprite.setPosition(position);
-			T* ptr = new T(this->sprite, this);
-			this->screen->add(ptr);
-			this->characters[ptr->getID()] = ptr;
+			this->spawn();
 		}
 		else { this->cooldown--; }
 	}
+
+	void spawn()
+	{
+		const TileMap* map = this->screen->getMap();
+		const std::vector<sf::Vector2f>& spawnPositions = map->getSafeSpawnPositions();
+		size_t randIndex = rand() % spawnPositions.size();
+		sf::Vector2f position = spawnPositions[randIndex];
+		this->sprite.setPosition(position);
+		T* ptr = new T(this->sprite, this);
+		this->screen->add(ptr);
+		this->characters[ptr->getID()] = ptr;
+	}
 public:
 	RespawnManager(Sprite::ID spriteID, int max, int respawnSpeed) : max(max), respawnSpeed(respawnSpeed), sprite(SpriteFactory::generateSprite(spriteID)) { }
 	
@@ -51,6 +56,12 @@ public:
 		this->characters.erase(character->getID());
 	}
 
+	//spawns characters immediately until the maximum is reached, the manager must already be added to a screen
+	void fill()
+	{
+		while (this->characters.size() < this->max) { this->spawn(); }
+	}
+
 	void clear()
 	{
 		for (auto ch : this->characters) { this->screen->remove(ch.second); }
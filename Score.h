@@ -15,12 +15,13 @@ namespace Engine
 	private:
 		bool frozen;
 		int number = 0;
-		sf::Text* text() { return dynamic_cast<sf::Text*>(this->getGraphic()); }
+		ResourceHandle<sf::Font> font;
+		sf::Text* text() { return this->getText(); }
 	public:
 		Score(sf::Text t) : GraphicalGameObject(t)
 		{
-			sf::Font* fontPtr = ResourceManager<sf::Font>::GetResource("zombie.ttf");
-			this->text()->setFont(*fontPtr);
+			this->font = ResourceManager<sf::Font>::AcquireResource("zombie.ttf");
+			this->text()->setFont(*this->font);
 			this->text()->setStyle(sf::Text::Bold);
 			this->text()->setOutlineColor({ 179, 45, 0 });
 			this->text()->setOutlineThickness(2.f);
@@ -143,6 +143,8 @@ namespace Engine
 		ScoreList easyScores;
 		ScoreList normalScores;
 		ScoreList hardScores;
+		ResourceHandle<sf::Font> font;
+		ResourceHandle<sf::Texture> backgroundTexture; //declared before the sprite, the scoreboard image is not in the atlas
 		sf::Text easyColumn;
 		sf::Text normalColumn;
 		sf::Text hardColumn;
@@ -151,7 +153,7 @@ namespace Engine
 		sf::Sprite normalButton;
 		sf::Sprite insaneButton;
 		sf::Sprite background;
-		sf::Sprite* backgroundPtr() { return dynamic_cast<sf::Sprite*>(this->graphic); }
+		sf::Sprite* backgroundPtr() { return this->getSprite(); }
 		bool showEasy = false;
 		bool showNormal = false;
 		bool showInsane = false;
@@ -179,19 +181,20 @@ namespace Engine
 			normalFileName("data/normalScores.dat"),
 			hardFileName("data/hardScores.dat"),
 			xButton(SpriteFactory::generateSprite(Sprite::ID::XButton)),
-			background(SpriteFactory::generateSprite(Sprite::ID::Scoreboard)),
+			background(SpriteFactory::generateSprite(Sprite::ID::Scoreboard, this->backgroundTexture)),
 			ezButton(SpriteFactory::generateSprite(Sprite::ID::EasyButton)),
 			normalButton(SpriteFactory::generateSprite(Sprite::ID::NormalButton)),
 			insaneButton(SpriteFactory::generateSprite(Sprite::ID::InsaneButton))
 		{
-			sf::Font* fontPtr = ResourceManager<sf::Font>::GetResource("harting.ttf");
+			this->subscribeEvents(MouseButtonEvents);
+			this->font = ResourceManager<sf::Font>::AcquireResource("harting.ttf");
 			this->easyScores.loadFromDataFile(this->easyFileName);
 			this->normalScores.loadFromDataFile(this->normalFileName);
 			this->hardScores.loadFromDataFile(this->hardFileName);
 			for (auto txt : { &this->easyColumn, &this->normalColumn, &this->hardColumn })
 			{
 				txt->setFillColor({ 179, 45, 0, 255 });
-				txt->setFont(*fontPtr);
+				txt->setFont(*this->font);
 				txt->setStyle(sf::Text::Bold);
 				txt->setCharacterSize(30);
 				txt->setLineSpacing(1.5f);
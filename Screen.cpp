@@ -4,22 +4,38 @@
 #include "GameObjectAttribute.h"
 #include "FileLoadException.h"
 #include "DebugManager.h"
+#include "AssetLoader.h"
+#include <cmath>
 #include <utility>
 #include <functional>
 
 using namespace Engine;
 
 static bool renderStarted = false;
+static bool headlessRunning = false;
+static InputSource* headlessInput = nullptr;
+static uint64_t frameCount = 0;
 static int currentFPS;
 static sf::RenderWindow* windowPtr = nullptr;
-static std::queue<std::pair<GameObject*, bool>> removeQueue;
+static vector<std::pair<GameObject*, bool>> removeQueue; //a vector keeps its storage between steps where a queue would allocate as it advances
 unsigned int Screen::windowWidth = 0;
 unsigned int Screen::windowHeight = 0;
 const char* Screen::windowTitle = nullptr;
+unsigned int Screen::frameRate = 60;
+FramePacer::Mode Screen::framePacingMode = FramePacer::Mode::HybridSleep;
 static Screen* currentScreen;
 static Screen* pendingSwitch;
 bool running = true;
 bool windowInitialized = false;
+static Screen::PhaseTimings phaseTimings;
+
+//position of the single bit set in an event group, which is also its subscriber list
+static int eventGroupIndex(uint8_t group)
+{
+	int index = 0;
+	while (!(group & (1 << index))) { index++; }
+	return index;
+}
 
 namespace Engine
 {	
@@ -28,12 +44,14 @@ namespace Engine
 	void Screen::addMap(TileMap* map)
 	{
 		this->tMap = map;
+		if (map != nullptr) { this->collisionGrid.setCellSize(map->tileSize()); }
 	}
 
 	void Screen::addMainCharacter(GraphicalGameObject* mainCharacter)
 	{
 		this->add(mainCharacter);
 		this->mainCharacter = mainCharacter;
+		this->mainCharacterSprite = mainCharacter->getSprite();
 		mainCharacter->AddedToScreen();
 	}
 
@@ -41,15 +59,24 @@ namespace Engine
 	{
 		if (gameObject == nullptr) { return; }
 		GameObjectID id = gameObject->getID();
-		this->allObjects[id] = gameObject;
-		if (GraphicalGameObject* ggo = dynamic_cast<GraphicalGameObject*>(gameObject)) { this->renderObjects[id] = ggo; }
-		if (GameObjectAttribute::Collision* collisionObject = dynamic_cast<GameObjectAttribute::Collision*>(gameObject)) { this->collisionObjects[id] = collisionObject; }
+		this->allObjects.insert(id, gameObject);
+		GraphicalGameObject* ggo = dynamic_cast<GraphicalGameObject*>(gameObject);
+		sf::Drawable* graphic = (ggo != nullptr) ? ggo->getGraphic() : nullptr;
+		if (ggo) { this->renderObjects.insert(id, { ggo, ggo->getSprite(), ggo->getShape() }); }
+		if (GameObjectAttribute::Collision* collisionObject = dynamic_cast<GameObjectAttribute::Collision*>(gameObject))
+		{
+			collisionObject->resolveDrawablePtr(graphic);
+			this->collisionObjects.insert(id, { collisionObject, collisionObject->getDrawablePtr(), gameObject, id, attributeFlagsOf(gameObject) });
+		}
 		if (GameObjectAttribute::Movement* movingObject = dynamic_cast<GameObjectAttribute::Movement*>(gameObject))
 		{
-			if (dynamic_cast<GameObjectAttribute::TerrainCollision*>(gameObject)) { this->movingObjectsWithTerrainCollision[id] = movingObject; }
-			else { this->movingObjects[id] = movingObject; }
+			movingObject->resolveDrawablePtr(graphic);
+			MovingEntry entry = { movingObject, dynamic_cast<GameObjectAttribute::TerrainCollision*>(gameObject), movingObject->getDrawablePtr() };
+			if (entry.terrainCollision) { this->movingObjectsWithTerrainCollision.insert(id, entry); }
+			else { this->movingObjects.insert(id, entry); }
 		}
 		gameObject->screen = this;
+		this->updateEventSubscriptions(gameObject);
 		gameObject->AddedToScreen();
 	}
 
@@ -62,9 +89,10 @@ namespace Engine
 		{ DebugManager::PrintMessage(DebugManager::MessageType::ERROR_REPORTING, "Argument to Screen::addUIObject should not inherit from GameObjectAttribute::Movement. It will not be added to list of moving objects."); }
 		#endif
 		GameObjectID id = uiObj->getID();
-		this->allObjects[id] = uiObj;
-		if (GraphicalGameObject* ggo = dynamic_cast<GraphicalGameObject*>(uiObj)) { this->uiObjects[id] = ggo; }
+		this->allObjects.insert(id, uiObj);
+		if (GraphicalGameObject* ggo = dynamic_cast<GraphicalGameObject*>(uiObj)) { this->uiObjects.insert(id, { ggo, ggo->getTransformable() }); }
 		uiObj->screen = this;
+		this->updateEventSubscriptions(uiObj);
 		uiObj->AddedToScreen();		
 	}
 
@@ -73,35 +101,78 @@ namespace Engine
 		return this->mainCharacter;
 	}
 
+	sf::Vector2f Screen::getMainCharacterPosition() const
+	{
+		return (this->mainCharacterSprite != nullptr) ? this->mainCharacterSprite->getPosition() : sf::Vector2f(0.f, 0.f);
+	}
+
+	uint8_t Screen::attributeFlagsOf(GameObject* gameObject)
+	{
+		uint8_t flags = 0;
+		if (dynamic_cast<GameObjectAttribute::Health*>(gameObject)) { flags |= HealthFlag; }
+		if (dynamic_cast<GameObjectAttribute::Movement*>(gameObject)) { flags |= MovementFlag; }
+		if (dynamic_cast<GameObjectAttribute::TerrainCollision*>(gameObject)) { flags |= TerrainCollisionFlag; }
+		if (dynamic_cast<GameObjectAttribute::Enemy*>(gameObject)) { flags |= EnemyFlag; }
+		if (dynamic_cast<GameObjectAttribute::Attacker*>(gameObject)) { flags |= AttackerFlag; }
+		if (dynamic_cast<GameObjectAttribute::Healer*>(gameObject)) { flags |= HealerFlag; }
+		if (dynamic_cast<GameObjectAttribute::SpriteSheet*>(gameObject)) { flags |= SpriteSheetFlag; }
+		return flags;
+	}
+
+	void Screen::updateEventSubscriptions(GameObject* gameObject)
+	{
+		GameObjectID id = gameObject->getID();
+		if (!this->allObjects.contains(id)) { return; }
+		for (int group = 0; group < eventGroupCount; group++)
+		{
+			if (gameObject->eventSubscriptions & (1 << group)) { this->eventSubscribers[group].insert(id, gameObject); }
+			else { this->eventSubscribers[group].erase(id); }
+		}
+	}
+
+	void Screen::eraseEventSubscriptions(GameObjectID id)
+	{
+		for (auto& subscribers : this->eventSubscribers) { subscribers.erase(id); }
+	}
+
+	//a run of MouseMoved events only matters for where it ends, so each run is replaced by its last event
+	//events of other types keep their order relative to the moves around them
+	void Screen::coalesceMouseMoves(vector<sf::Event>& events)
+	{
+		size_t kept = 0;
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			if (kept > 0 && events[i].type == sf::Event::MouseMoved && events[kept - 1].type == sf::Event::MouseMoved)
+			{
+				events[kept - 1] = events[i];
+				phaseTimings.mouseMovesCoalesced++;
+			}
+			else { events[kept++] = events[i]; }
+		}
+		events.resize(kept);
+	}
+
 	bool Screen::find(GameObject* gameObject)
 	{
 		GameObjectID id = gameObject->getID();
-		return (gameObject == this->mainCharacter) || (this->allObjects.find(id) != this->allObjects.end());
+		return (gameObject == this->mainCharacter) || this->allObjects.contains(id);
 	}
 
 	void Screen::remove(GameObject* gameObject, bool autoDelete)
 	{
 		if (this != currentScreen)
 		{	
-			GameObjectID id = gameObject->getID();
-			if (this->allObjects.erase(id) |
-				this->renderObjects.erase(id) |
-				this->uiObjects.erase(id) |
-				this->collisionObjects.erase(id) |
-				this->movingObjects.erase(id) |
-				this->movingObjectsWithTerrainCollision.erase(id))
-			{
-				if (autoDelete) { delete gameObject; }
-			}
+			this->removeNow(gameObject, autoDelete);
 		}
 		else
 		{
-			removeQueue.push({ gameObject, autoDelete });
+			removeQueue.push_back({ gameObject, autoDelete });
 		}
 	}
 
 	sf::Vector2i Screen::getMousePosition() const
 	{
+		if (headlessRunning) { return (headlessInput) ? headlessInput->getMousePosition() : sf::Vector2i(0, 0); }
 		if (!windowPtr) { return sf::Vector2i(0, 0); }
 		sf::Vector2i pixelPos = sf::Mouse::getPosition(*windowPtr);
 		sf::Vector2f worldPos = windowPtr->mapPixelToCoords(pixelPos, windowPtr->getView());
@@ -113,6 +184,17 @@ namespace Engine
 		return this->tMap;
 	}
 
+	const FlowField& Screen::getPlayerFlowField()
+	{
+		if (this->tMap != nullptr && this->mainCharacterSprite != nullptr)
+		{
+			sf::FloatRect bounds = this->mainCharacterSprite->getGlobalBounds();
+			sf::Vector2f center(bounds.left + bounds.width / 2.f, bounds.top + bounds.height / 2.f);
+			if (this->playerFlowField.update(*this->tMap, center)) { phaseTimings.flowFieldRebuilds++; }
+		}
+		return this->playerFlowField;
+	}
+
 	void Screen::close()
 	{
 		running = false;
@@ -120,14 +202,16 @@ namespace Engine
 
 	void Screen::render()
 	{
-		constexpr int fps = 60;
-		constexpr int frameDurationMicroseconds = 1000000 / fps;
+		if (headlessRunning)
+		{
+			pendingSwitch = this;
+			return;
+		}
 		unsigned int width = (Screen::windowWidth) ? Screen::windowWidth : 500;
 		unsigned int height = (Screen::windowHeight) ? Screen::windowHeight : 500;
 		const char* title = (Screen::windowTitle) ? Screen::windowTitle : "<no title>";
 		static sf::RenderWindow window(sf::VideoMode(width, height), title, sf::Style::Close);
-		static sf::Clock clock;
-		static uint64_t frameCount = 0;
+		static FramePacer pacer;
 		sf::View view(sf::Vector2f(static_cast<float>(width / 2), static_cast<float>(height / 2)), sf::Vector2f(static_cast<float>(width), static_cast<float>(height)));
 		windowPtr = &window;
 		window.setView(view);
@@ -139,30 +223,23 @@ namespace Engine
 		else { pendingSwitch = nullptr; }
 		currentScreen = this;
 		renderStarted = true;
-		#ifdef _DEBUG
-		sf::Clock eventClock;
-		sf::Clock collisionClock;
-		sf::Clock movementClock;
+		pacer.setTargetFrameRate(Screen::frameRate);
+		pacer.setMode(Screen::framePacingMode);
+		pacer.apply(window);
+		constexpr sf::Int64 tickDurationMicroseconds = 1000000 / static_cast<sf::Int64>(TimeUnit::ticksPerSecond);
+		constexpr sf::Int64 maxAccumulatedMicroseconds = tickDurationMicroseconds * 8; //past this the game slows down instead of spiralling into ever longer catch up frames
+		sf::Clock simulationClock;
+		sf::Int64 accumulator = tickDurationMicroseconds; //guarantees one simulation step before the first draw
+		sf::Clock frameClock;
 		sf::Clock drawClock;
-		sf::Int64 eventDurationSum = 0;
-		sf::Int64 collisionDurationSum = 0;
-		sf::Int64 movementDurationSum = 0;
-		sf::Int64 drawDurationSum = 0;
-		sf::Int64 frameDurationSum = 0;
-		#endif
+		Screen::resetPhaseTimings();
 		
 		//game loop
 		while (window.isOpen() && !pendingSwitch)
 		{
-			clock.restart();
-			#ifdef _DEBUG
-			eventClock.restart();
-			#endif
-
-			for (auto const & pair : this->allObjects)
-			{
-				pair.second->EveryFrame(frameCount);
-			}
+			frameClock.restart();
+			accumulator += simulationClock.restart().asMicroseconds();
+			if (accumulator > maxAccumulatedMicroseconds) { accumulator = maxAccumulatedMicroseconds; }
 
 			sf::Event ev;
 			while (window.pollEvent(ev))
@@ -178,284 +255,426 @@ namespace Engine
 					sf::FloatRect visibleArea(0.f, 0.f, static_cast<float>(ev.size.width), static_cast<float>(ev.size.height));
 					view = sf::View(visibleArea);
 				}
-				//handle events on each object
-				for (auto & pair : this->allObjects)
-				{
-					GameObject* obj = pair.second;
-					if (!obj->eventsDisabled) { obj->dispatchEvent(ev); }
-				}
+				this->pendingEvents.push_back(ev);
 			}
-			#ifdef _DEBUG
-			eventDurationSum += eventClock.getElapsedTime().asMicroseconds();
-			movementClock.restart();
-			#endif
 
-			//handle movement and terrain collision
-			for (auto const & pair : this->movingObjectsWithTerrainCollision)
+			//resources decoded in the background since the last frame are handed to the main thread, e.g. textures are uploaded
+			AssetLoader::finishLoads();
+
+			//the simulation advances in fixed steps so game speed does not depend on the render rate
+			while (accumulator >= tickDurationMicroseconds && !pendingSwitch)
 			{
-				GameObjectAttribute::Movement* obj = pair.second;
-				if (obj->xVelocity == 0.0 && obj->yVelocity == 0.0) { continue; }
-				sf::Sprite* spr = obj->getDrawablePtr();
-				sf::Vector2f position = spr->getPosition();
-				sf::Vector2f velocity = obj->getVelocity();
-				obj->xVelocity = 0.0;
-				obj->yVelocity = 0.0;
-				sf::FloatRect collisionSize = dynamic_cast<TerrainCollision*>(obj)->getObstacleCollisionSize();
-				sf::IntRect tRect = obj->getDrawablePtr()->getTextureRect();
-				auto tryMove = [&](float vx, float vy)
-				{
-					sf::Vector2f destination(position.x + vx, position.y + vy);
-					float x = destination.x + collisionSize.left;
-					float y = destination.y + collisionSize.top;
-					sf::Vector2f mapBoundsCollisionCorners[4] = {
-						{x, y},
-						{x + static_cast<float>(tRect.width), y},
-						{x + static_cast<float>(tRect.width), y + static_cast<float>(tRect.height)},
-						{x, y + static_cast<float>(tRect.height)}
-					};
-					for (auto const & corner : mapBoundsCollisionCorners)
-					{
-						if (this->tMap->isOutOfBounds(corner)) { return false; }
-					}
-					sf::Vector2f terrainCollisionCorners[4] = {
-						{x, y},
-						{x + collisionSize.width, y},
-						{x + collisionSize.width, y + collisionSize.height},
-						{x, y + collisionSize.height}
-					};
-					for (auto const & corner : terrainCollisionCorners)
-					{
-						if (this->tMap->isObstacle(corner)) { return false; }
-					}
-					spr->setPosition(destination);
-					return true;
-				};
-				if (tryMove(velocity.x, velocity.y)) { continue; }
-				if (tryMove(velocity.x, 0.f)) { continue; }
-				if (tryMove(0.f, velocity.y)) { continue; }
+				this->update(frameCount);
+				frameCount++;
+				accumulator -= tickDurationMicroseconds;
 			}
+			if (pendingSwitch) { break; }
+
+			drawClock.restart();
+			this->draw(window, view, static_cast<float>(accumulator) / static_cast<float>(tickDurationMicroseconds));
+			phaseTimings.draw += drawClock.getElapsedTime().asMicroseconds();
+
+			window.setView(view);
+			window.display();
 
-			//handle movement of objects that ignore terrain
-			for (auto const & pair : this->movingObjects)
+			phaseTimings.frame += frameClock.getElapsedTime().asMicroseconds();
+			phaseTimings.renderedFrames++;
+			#ifdef _DEBUG
+			if (phaseTimings.steps >= 60 && phaseTimings.renderedFrames > 0)
 			{
-				GameObjectAttribute::Movement* obj = pair.second;
-				if (obj->xVelocity == 0.0 && obj->yVelocity == 0.0) { continue; }
-				sf::Sprite* spr = obj->getDrawablePtr();
-				spr->move(obj->getVelocity());
-				obj->xVelocity = 0.0;
-				obj->yVelocity = 0.0;
+				sf::Int64 steps = static_cast<sf::Int64>(phaseTimings.steps);
+				sf::Int64 frames = static_cast<sf::Int64>(phaseTimings.renderedFrames);
+				DebugManager::MessageType msgType = DebugManager::MessageType::PERFORMANCE_REPORTING;
+				DebugManager::PrintMessage(msgType, string("\naverage event compute time: ") + std::to_string(phaseTimings.events / steps));
+				DebugManager::PrintMessage(msgType, string("average movement compute time: ") + std::to_string(phaseTimings.movement / steps));
+				DebugManager::PrintMessage(msgType, string("average collision compute time: ") + std::to_string(phaseTimings.collision / steps));
+				DebugManager::PrintMessage(msgType, string("average collision pairs tested: ") + std::to_string(phaseTimings.collisionPairsTested / phaseTimings.steps));
+				DebugManager::PrintMessage(msgType, string("average collision pairs hit: ") + std::to_string(phaseTimings.collisionPairsHit / phaseTimings.steps));
+				DebugManager::PrintMessage(msgType, string("average removal compute time: ") + std::to_string(phaseTimings.removal / steps));
+				DebugManager::PrintMessage(msgType, string("average draw compute time: ") + std::to_string(phaseTimings.draw / frames));
+				DebugManager::PrintMessage(msgType, string("average objects drawn: ") + std::to_string(phaseTimings.objectsDrawn / phaseTimings.renderedFrames));
+				DebugManager::PrintMessage(msgType, string("average objects culled: ") + std::to_string(phaseTimings.objectsCulled / phaseTimings.renderedFrames));
+				DebugManager::PrintMessage(msgType, string("average sprites batched: ") + std::to_string(phaseTimings.spritesBatched / phaseTimings.renderedFrames));
+				DebugManager::PrintMessage(msgType, string("average sprite batch draw calls: ") + std::to_string(phaseTimings.spriteBatchDrawCalls / phaseTimings.renderedFrames));
+				DebugManager::PrintMessage(msgType, string("average total compute time: ") + std::to_string(phaseTimings.frame / frames));
+				DebugManager::PrintMessage(msgType, string("simulation steps per rendered frame: ") + std::to_string(static_cast<double>(steps) / static_cast<double>(frames)));
+				DebugManager::PrintMessage(msgType, string("max total before slowdown: ") + std::to_string(pacer.getFrameDurationMicroseconds()));
+				DebugManager::PrintMessage(msgType, string("average frame time jitter: ") + std::to_string(pacer.getAverageJitterMicroseconds()));
+				DebugManager::PrintMessage(msgType, string("max frame time jitter: ") + std::to_string(pacer.getMaxJitterMicroseconds()));
+				pacer.resetJitterStatistics();
+				Screen::resetPhaseTimings();
 			}
-			#ifdef _DEBUG
-			movementDurationSum += movementClock.getElapsedTime().asMicroseconds();
-			collisionClock.restart();
 			#endif
+			pacer.waitForNextFrame();
+		}
+		//end game loop
 
-			//object collision
-			for (auto & p1 : this->collisionObjects)
+		if (pendingSwitch)
+		{
+			renderStarted = false;
+			//events polled for this screen must not reach it when it is shown again
+			this->pendingEvents.clear();
+			pendingSwitch->render();
+		}
+	}
+
+	//runs the simulation without a window or any draw calls, as fast as the cpu allows
+	//if drawTarget is given, each step is also drawn to it (without display) so the cpu cost of drawing can be measured
+	//returns the number of steps simulated, which is less than requested only if the screen was closed
+	uint64_t Screen::runHeadless(uint64_t frames, InputSource* input, sf::RenderWindow* drawTarget)
+	{
+		if (renderStarted || headlessRunning) { return 0; }
+		headlessRunning = true;
+		//a close from an earlier run would otherwise end this one before its first step
+		running = true;
+		headlessInput = input;
+		uint64_t step = 0;
+		Screen* screen = this;
+		sf::Clock drawClock;
+		while (screen != nullptr)
+		{
+			//a screen switch requested during a step continues the run on the new screen
+			pendingSwitch = nullptr;
+			currentScreen = screen;
+			sf::View view = (drawTarget) ? drawTarget->getDefaultView() : sf::View();
+			while (step < frames && running && !pendingSwitch)
 			{
-				GameObjectAttribute::Collision* eventReceiver = p1.second;
-				for (auto & p2 : this->collisionObjects)
+				AssetLoader::finishLoads();
+				if (input) { input->poll(step, screen->pendingEvents); }
+				screen->update(frameCount);
+				frameCount++;
+				step++;
+				if (drawTarget && !pendingSwitch)
 				{
-					GameObjectAttribute::Collision* eventArg = p2.second;
-					if (eventReceiver != eventArg && eventReceiver->CheckCollision(eventArg)) { eventReceiver->Collided(eventArg); }
+					drawClock.restart();
+					screen->draw(*drawTarget, view, 1.f);
+					drawTarget->setView(view);
+					phaseTimings.draw += drawClock.getElapsedTime().asMicroseconds();
+					phaseTimings.renderedFrames++;
 				}
 			}
-			#ifdef _DEBUG
-			collisionDurationSum += collisionClock.getElapsedTime().asMicroseconds();
-			drawClock.restart();
-			#endif
+			screen->pendingEvents.clear();
+			screen = pendingSwitch;
+		}
+		headlessRunning = false;
+		headlessInput = nullptr;
+		currentScreen = nullptr;
+		return step;
+	}
 
-			//draw
-			window.clear();
+	const Screen::PhaseTimings& Screen::getPhaseTimings()
+	{
+		return phaseTimings;
+	}
 
-			//draw the map
-			if (this->tMap) { window.draw(*this->tMap); }
+	void Screen::resetPhaseTimings()
+	{
+		phaseTimings = PhaseTimings();
+	}
 
-			//draw the objects
-			for (auto & pair : this->renderObjects)
-			{
-				GraphicalGameObject* obj = pair.second;
-				obj->draw(window);
-			}
+	void Screen::update(uint64_t frameNumber)
+	{
+		sf::Clock phaseClock;
+		this->timers.advance();
 
-			//draw the UI objects
-			for (auto const & pair : this->uiObjects)
-			{
-				GraphicalGameObject* obj = pair.second;
-				sf::Transformable* transformable = dynamic_cast<sf::Transformable*>(obj->getGraphic());
-				if (!transformable) { continue; }
-				sf::Vector2f viewPos = window.getView().getCenter();
-				sf::Vector2f screenPosition = transformable->getPosition();
-				transformable->setPosition(viewPos - sf::Vector2f(static_cast<float>(this->windowWidth / 2), static_cast<float>(this->windowHeight / 2)) + screenPosition);
-				obj->draw(window);
-				transformable->setPosition(screenPosition);
-			}
+		//indexed loops pick up objects added by the objects themselves during the pass
+		for (size_t i = 0; i < this->allObjects.size(); i++)
+		{
+			this->allObjects[i]->EveryFrame(frameNumber);
+		}
 
-			//view moves with character
-			sf::Sprite* mainCharacterSprite = (this->mainCharacter != nullptr) ? dynamic_cast<sf::Sprite*>(this->mainCharacter->graphic) : nullptr;
-			if (mainCharacterSprite != nullptr)
+		//hand each event to the objects subscribed to its group, a burst of mouse moves costs one dispatch
+		coalesceMouseMoves(this->pendingEvents);
+		for (auto const & ev : this->pendingEvents)
+		{
+			uint8_t group = GameObject::eventGroupOf(ev.type);
+			if (group == GameObject::NoEvents) { continue; }
+			//handlers can unsubscribe, and erasing from the list moves its last subscriber, so the list is walked from a copy
+			//objects unsubscribed by an earlier handler are skipped, objects subscribed during the dispatch get the next event
+			DenseObjectMap<GameObject*>& subscribers = this->eventSubscribers[eventGroupIndex(group)];
+			this->dispatchSnapshot.assign(subscribers.begin(), subscribers.end());
+			for (GameObject* obj : this->dispatchSnapshot)
 			{
-				unsigned int mapWidth = 0;
-				unsigned int mapHeight = 0;
-				if (this->tMap != nullptr)
-				{
-					mapWidth = this->tMap->width() * this->tMap->tileSize().x;
-					mapHeight = this->tMap->height() * this->tMap->tileSize().y;
-				}
-				sf::Vector2f pos = mainCharacterSprite->getPosition();
-				sf::Vector2f origin = mainCharacterSprite->getOrigin();
-				float x = pos.x + origin.x;
-				float y = pos.y + origin.y;
-				float fWidth = static_cast<float>(mapWidth);
-				float fHeight = static_cast<float>(mapHeight);
-				float halfWidth = static_cast<float>(windowWidth / 2);
-				float halfHeight = static_cast<float>(windowHeight / 2);
-				if (x > halfWidth && x < (fWidth - halfWidth)
-					&& y > halfHeight && y < (fHeight - halfHeight))
-				{
-					view.setCenter(pos);
-				}
-				else if (x >= 0.f && x <= halfWidth &&
-					y >= 0.f && y <= halfHeight)
-				{
-					view.setCenter(halfWidth, halfHeight);
-				}
-				else if (x >= 0.f && x <= halfWidth &&
-					y >= fHeight - halfHeight && y <= fHeight)
-				{
-					view.setCenter(halfWidth, fHeight - halfHeight);
-				}
-				else if (x >= fWidth - halfWidth && x <= fWidth &&
-					y >= 0.f && y <= halfHeight)
+				if (!subscribers.contains(obj->getID())) { continue; }
+				if (!obj->eventsDisabled)
 				{
-					view.setCenter(fWidth - halfWidth, halfHeight);
-				}
-				else if (x >= fWidth - halfWidth && x <= fWidth &&
-					y >= fHeight - halfHeight && y <= fHeight)
-				{
-					view.setCenter(fWidth - halfWidth, fHeight - halfHeight);
-				}
-				else if (x > halfWidth && x < fWidth - halfWidth &&
-					y >= 0.f && y <= halfHeight)
-				{
-					view.setCenter(x, halfHeight);
-				}
-				else if (x > halfWidth && x < fWidth - halfWidth &&
-					y >= fHeight - halfHeight && y <= fHeight)
-				{
-					view.setCenter(x, fHeight - halfHeight);
-				}
-				else if (x >= 0.f && x <= halfWidth &&
-					y > halfHeight && y < fHeight - halfHeight)
-				{
-					view.setCenter(halfWidth, y);
-				}
-				else if (x >= fWidth - halfWidth && x <= fWidth &&
-					y > halfHeight && y < mapHeight - halfHeight)
-				{
-					view.setCenter(fWidth - halfWidth, y);
+					obj->dispatchEvent(ev);
+					phaseTimings.eventsDispatched++;
 				}
 			}
-			#ifdef _DEBUG
-			drawDurationSum += drawClock.getElapsedTime().asMicroseconds();
-			#endif
+		}
+		this->pendingEvents.clear();
+		phaseTimings.events += phaseClock.restart().asMicroseconds();
 
-			window.setView(view);
-			window.display();
+		this->updateMovement();
+		phaseTimings.movement += phaseClock.restart().asMicroseconds();
+
+		this->updateCollisions();
+		phaseTimings.collision += phaseClock.restart().asMicroseconds();
+
+		this->processRemoveQueue();
+		phaseTimings.removal += phaseClock.restart().asMicroseconds();
+		phaseTimings.steps++;
+	}
 
-			//remove objects that are pending to be removed
-			while (!removeQueue.empty())
+	void Screen::updateMovement()
+	{
+		//handle movement and terrain collision
+		for (MovingEntry const & entry : this->movingObjectsWithTerrainCollision)
+		{
+			GameObjectAttribute::Movement* obj = entry.movement;
+			obj->lastDisplacement = sf::Vector2f(0.f, 0.f);
+			if (obj->xVelocity == 0.0 && obj->yVelocity == 0.0) { continue; }
+			sf::Sprite* spr = entry.sprite;
+			sf::Vector2f position = spr->getPosition();
+			sf::Vector2f velocity = obj->getVelocity();
+			obj->xVelocity = 0.0;
+			obj->yVelocity = 0.0;
+			sf::FloatRect collisionSize = entry.terrainCollision->getObstacleCollisionSize();
+			sf::IntRect tRect = spr->getTextureRect();
+
+			//the texture sized box has to stay on the map and the collision box has to stay out of obstacles
+			//x is resolved before y so an object pushing diagonally into a wall slides along it
+			sf::FloatRect boundsBox(position.x + collisionSize.left, position.y + collisionSize.top, static_cast<float>(tRect.width), static_cast<float>(tRect.height));
+			sf::FloatRect terrainBox(position.x + collisionSize.left, position.y + collisionSize.top, collisionSize.width, collisionSize.height);
+			auto sweep = [&](float delta, bool horizontal)
 			{
-				std::pair<GameObject*, bool> pRemove = removeQueue.front();
-				GameObject* toRemove = pRemove.first;
-				bool autoDelete = pRemove.second;
-				bool removed = false;
-				removeQueue.pop();
-				GameObjectID id = toRemove->getID();
-				if(	this->allObjects.erase(id) |
-					this->renderObjects.erase(id) |
-					this->uiObjects.erase(id) |
-					this->collisionObjects.erase(id) |
-					this->movingObjects.erase(id) |
-					this->movingObjectsWithTerrainCollision.erase(id))
-				{
-					toRemove->RemovedFromScreen();
-					if (autoDelete) { delete toRemove; }
-				}
-			}
+				float allowed = this->tMap->sweepAxis(boundsBox, delta, horizontal, TileProperties::OutOfBounds);
+				float terrainAllowed = this->tMap->sweepAxis(terrainBox, delta, horizontal, TileProperties::Obstacle);
+				return (std::abs(terrainAllowed) < std::abs(allowed)) ? terrainAllowed : allowed;
+			};
+			sf::Vector2f displacement;
+			displacement.x = sweep(velocity.x, true);
+			boundsBox.left += displacement.x;
+			terrainBox.left += displacement.x;
+			displacement.y = sweep(velocity.y, false);
+			spr->setPosition(position + displacement);
+			obj->lastDisplacement = displacement;
+		}
 
-			#ifdef _DEBUG
-			frameDurationSum += clock.getElapsedTime().asMicroseconds();
-			int avgFrameReportFrequency = 60;
-			if (frameCount % avgFrameReportFrequency == 0)
+		//handle movement of objects that ignore terrain
+		for (MovingEntry const & entry : this->movingObjects)
+		{
+			GameObjectAttribute::Movement* obj = entry.movement;
+			obj->lastDisplacement = obj->getVelocity();
+			if (obj->xVelocity == 0.0 && obj->yVelocity == 0.0) { continue; }
+			entry.sprite->move(obj->getVelocity());
+			obj->xVelocity = 0.0;
+			obj->yVelocity = 0.0;
+		}
+	}
+
+	void Screen::updateCollisions()
+	{
+		//object collision, only objects sharing a grid cell are tested against each other
+		this->collisionGrid.clear();
+		for (CollisionEntry const & entry : this->collisionObjects)
+		{
+			if (entry.sprite) { this->collisionGrid.insert(entry, entry.sprite->getGlobalBounds()); }
+		}
+		this->collisionGrid.forEachOverlappingPair([&](CollisionEntry const & first, CollisionEntry const & second)
+		{
+			GameObjectAttribute::Collision* a = first.collision;
+			GameObjectAttribute::Collision* b = second.collision;
+			phaseTimings.collisionPairsTested++;
+			//a hit is counted once per pair like the test above, even when both objects report it
+			bool hit = false;
+			if (a->CheckCollision(b))
 			{
-				DebugManager::MessageType msgType = DebugManager::MessageType::PERFORMANCE_REPORTING;
-				DebugManager::PrintMessage(msgType, string("\naverage event compute time: ") + std::to_string(eventDurationSum / avgFrameReportFrequency));
-				DebugManager::PrintMessage(msgType, string("average movement compute time: ") + std::to_string(movementDurationSum / avgFrameReportFrequency));
-				DebugManager::PrintMessage(msgType, string("average collision compute time: ") + std::to_string(collisionDurationSum / avgFrameReportFrequency));
-				DebugManager::PrintMessage(msgType, string("average draw compute time: ") + std::to_string(drawDurationSum / avgFrameReportFrequency));
-				DebugManager::PrintMessage(msgType, string("average total compute time: ") + std::to_string(frameDurationSum / avgFrameReportFrequency));
-				DebugManager::PrintMessage(msgType, string("max total before slowdown: ") + std::to_string(frameDurationMicroseconds));
-				frameDurationSum = 0;
-				eventDurationSum = 0;
-				movementDurationSum = 0;
-				collisionDurationSum = 0;
-				drawDurationSum = 0;
+				a->Collided(b);
+				hit = true;
 			}
-			#endif
-			frameCount++;
-			while (clock.getElapsedTime().asMicroseconds() < frameDurationMicroseconds) {}
+			if (b->CheckCollision(a))
+			{
+				b->Collided(a);
+				hit = true;
+			}
+			if (hit) { phaseTimings.collisionPairsHit++; }
+		});
+	}
+
+	void Screen::processRemoveQueue()
+	{
+		//remove objects that are pending to be removed, an indexed loop picks up removals requested by RemovedFromScreen
+		for (size_t i = 0; i < removeQueue.size(); i++)
+		{
+			std::pair<GameObject*, bool> pRemove = removeQueue[i];
+			this->removeNow(pRemove.first, pRemove.second);
 		}
-		//end game loop
+		removeQueue.clear();
+	}
 
-		if (pendingSwitch)
+	//pooled objects are never deleted here, RemovedFromScreen gives them back to their pool
+	void Screen::removeNow(GameObject* gameObject, bool autoDelete)
+	{
+		GameObjectID id = gameObject->getID();
+		if(	this->allObjects.erase(id) |
+			this->renderObjects.erase(id) |
+			this->uiObjects.erase(id) |
+			this->collisionObjects.erase(id) |
+			this->movingObjects.erase(id) |
+			this->movingObjectsWithTerrainCollision.erase(id))
 		{
-			renderStarted = false;
-			pendingSwitch->render();
+			this->eraseEventSubscriptions(id);
+			gameObject->RemovedFromScreen();
+			if (autoDelete && !gameObject->pooled) { delete gameObject; }
 		}
 	}
 
-	Screen::~Screen()
+	void Screen::draw(sf::RenderWindow& window, sf::View& view, float interpolation)
 	{
-		vector<GameObject*> objs;
-		for (auto const & iter : this->allObjects)
+		//moving sprites are drawn between their previous and current simulated positions
+		auto interpolate = [&](MovingEntry const & entry)
+		{
+			sf::Vector2f displacement = entry.movement->lastDisplacement;
+			if (displacement.x == 0.f && displacement.y == 0.f) { return; }
+			this->interpolatedSprites.push_back({ entry.sprite, entry.sprite->getPosition() });
+			entry.sprite->move(displacement * (interpolation - 1.f));
+		};
+		for (MovingEntry const & entry : this->movingObjectsWithTerrainCollision) { interpolate(entry); }
+		for (MovingEntry const & entry : this->movingObjects) { interpolate(entry); }
+
+		window.clear();
+
+		//draw the map
+		if (this->tMap) { window.draw(*this->tMap); }
+
+		//draw the objects, sprites drawn by the default draw go into one batch per texture
+		//objects with their own draw are drawn after the batch so things like health bars stay on top
+		//anything whose bounds miss the view is skipped
+		this->unbatchedObjects.clear();
+		const sf::View& currentView = window.getView();
+		sf::FloatRect viewRect(currentView.getCenter() - currentView.getSize() / 2.f, currentView.getSize());
+		for (size_t i = 0; i < this->renderObjects.size(); i++)
 		{
-			objs.push_back(iter.second);
+			RenderEntry const & entry = this->renderObjects[i];
+			if ((entry.sprite && !viewRect.intersects(entry.sprite->getGlobalBounds())) || (entry.shape && !viewRect.intersects(entry.shape->getGlobalBounds())))
+			{
+				phaseTimings.objectsCulled++;
+				continue;
+			}
+			phaseTimings.objectsDrawn++;
+			if (!entry.object->defaultDraw || entry.sprite == nullptr || !this->spriteBatch.add(*entry.sprite)) { this->unbatchedObjects.push_back(entry.object); }
 		}
-		for (auto const & obj : objs)
+		this->spriteBatch.flush(window);
+		GraphicalGameObject::activeBatch = &this->spriteBatch;
+		for (GraphicalGameObject* obj : this->unbatchedObjects) { obj->draw(window); }
+		GraphicalGameObject::activeBatch = nullptr;
+		this->spriteBatch.flush(window); //objects drawn with the default draw for the first time
+		phaseTimings.spritesBatched += this->spriteBatch.getSpriteCount();
+		phaseTimings.spriteBatchDrawCalls += this->spriteBatch.getDrawCalls();
+		this->spriteBatch.resetStatistics();
+
+		//draw the UI objects
+		for (size_t i = 0; i < this->uiObjects.size(); i++)
 		{
-			this->remove(obj);
+			GraphicalGameObject* obj = this->uiObjects[i].object;
+			sf::Transformable* transformable = this->uiObjects[i].transformable;
+			if (!transformable) { continue; }
+			sf::Vector2f viewPos = window.getView().getCenter();
+			sf::Vector2f screenPosition = transformable->getPosition();
+			transformable->setPosition(viewPos - sf::Vector2f(static_cast<float>(this->windowWidth / 2), static_cast<float>(this->windowHeight / 2)) + screenPosition);
+			obj->draw(window);
+			transformable->setPosition(screenPosition);
 		}
+
+		//view moves with character
+		this->updateView(view);
+
+		for (auto const & saved : this->interpolatedSprites) { saved.first->setPosition(saved.second); }
+		this->interpolatedSprites.clear();
 	}
-	
-	class Scheduler : public GameObject
+
+	void Screen::updateView(sf::View& view) const
 	{
-	private:
-		uint64_t delay;
-		uint64_t countdown;
-		uint16_t repeatsRemaining;
-		bool infinite;
-		function<void()> func;
-	public:
-		Scheduler( function<void()> func, uint64_t delay, uint16_t repeatCount) : delay(delay), countdown(delay), repeatsRemaining(repeatCount), infinite(repeatCount == 0), func(func) {}
-		void EveryFrame(uint64_t f)
+		sf::Sprite* mainCharacterSprite = this->mainCharacterSprite;
+		if (mainCharacterSprite != nullptr)
 		{
-			if (this->countdown == 0)
+			unsigned int mapWidth = 0;
+			unsigned int mapHeight = 0;
+			if (this->tMap != nullptr)
 			{
-				func();
-				if (repeatsRemaining > 0)
-				{
-					repeatsRemaining--;
-					this->countdown = this->delay;
-				}
-				else if(!this->infinite) { this->screen->remove(this); }				
+				mapWidth = this->tMap->width() * this->tMap->tileSize().x;
+				mapHeight = this->tMap->height() * this->tMap->tileSize().y;
+			}
+			sf::Vector2f pos = mainCharacterSprite->getPosition();
+			sf::Vector2f origin = mainCharacterSprite->getOrigin();
+			float x = pos.x + origin.x;
+			float y = pos.y + origin.y;
+			float fWidth = static_cast<float>(mapWidth);
+			float fHeight = static_cast<float>(mapHeight);
+			float halfWidth = static_cast<float>(windowWidth / 2);
+			float halfHeight = static_cast<float>(windowHeight / 2);
+			if (x > halfWidth && x < (fWidth - halfWidth)
+				&& y > halfHeight && y < (fHeight - halfHeight))
+			{
+				view.setCenter(pos);
+			}
+			else if (x >= 0.f && x <= halfWidth &&
+				y >= 0.f && y <= halfHeight)
+			{
+				view.setCenter(halfWidth, halfHeight);
+			}
+			else if (x >= 0.f && x <= halfWidth &&
+				y >= fHeight - halfHeight && y <= fHeight)
+			{
+				view.setCenter(halfWidth, fHeight - halfHeight);
+			}
+			else if (x >= fWidth - halfWidth && x <= fWidth &&
+				y >= 0.f && y <= halfHeight)
+			{
+				view.setCenter(fWidth - halfWidth, halfHeight);
+			}
+			else if (x >= fWidth - halfWidth && x <= fWidth &&
+				y >= fHeight - halfHeight && y <= fHeight)
+			{
+				view.setCenter(fWidth - halfWidth, fHeight - halfHeight);
+			}
+			else if (x > halfWidth && x < fWidth - halfWidth &&
+				y >= 0.f && y <= halfHeight)
+			{
+				view.setCenter(x, halfHeight);
+			}
+			else if (x > halfWidth && x < fWidth - halfWidth &&
+				y >= fHeight - halfHeight && y <= fHeight)
+			{
+				view.setCenter(x, fHeight - halfHeight);
+			}
+			else if (x >= 0.f && x <= halfWidth &&
+				y > halfHeight && y < fHeight - halfHeight)
+			{
+				view.setCenter(halfWidth, y);
+			}
+			else if (x >= fWidth - halfWidth && x <= fWidth &&
+				y > halfHeight && y < mapHeight - halfHeight)
+			{
+				view.setCenter(fWidth - halfWidth, y);
 			}
-			else { this->countdown--; }
 		}
-	};
+	}
+
+	Screen::~Screen()
+	{
+		//removals queued while this screen was current would otherwise outlive it
+		if (currentScreen == this)
+		{
+			removeQueue.clear();
+			currentScreen = nullptr;
+		}
+		//taken one at a time since RemovedFromScreen may remove other objects
+		while (!this->allObjects.empty())
+		{
+			this->removeNow(*this->allObjects.begin(), true);
+		}
+	}
+	
+	TimerWheel::Handle Screen::schedule(function<void()> func, TimeUnit::Time delay, uint16_t repeatCount)
+	{
+		return this->timers.schedule(std::move(func), delay, repeatCount);
+	}
 
-	void Screen::schedule(function<void()> func, TimeUnit::Time delay, uint16_t repeatCount)
+	bool Screen::cancel(TimerWheel::Handle handle)
 	{
-		this->add(new Scheduler(func, delay, repeatCount));
+		return this->timers.cancel(handle);
 	}
 }
\ No newline at end of file
@@ -6,21 +6,31 @@
 #include "TileMap.h"
 #include "MusicPlayer.h"
 #include "SoundPlayer.h"
+#include "SpatialGrid.h"
+#include "FramePacer.h"
+#include "InputSource.h"
+#include "DenseObjectMap.h"
+#include "SpriteBatch.h"
+#include "FlowField.h"
+#include "TimerWheel.h"
 #include <map>
+#include <limits>
+#include <type_traits>
 #include <functional>
-#include <queue>
 #include <vector>
 #include <utility>
 
 using std::function;
 using std::vector;
-using std::unordered_map;
 using std::map;
 
 namespace Engine
 {
 	namespace TimeUnit
 	{
+		//the simulation always advances at this rate, independent of the render frame rate
+		constexpr uint64_t ticksPerSecond = 60;
+
 		class Time
 		{
 		public:
@@ -33,13 +43,13 @@ namespace Engine
 		class Minutes : public Time
 		{
 		public:
-			Minutes(uint64_t minutes) : Time(minutes * 60 * 60) {}
+			Minutes(uint64_t minutes) : Time(minutes * 60 * ticksPerSecond) {}
 		};
 
 		class Seconds : public Time
 		{
 		public:
-			Seconds(uint64_t seconds) : Time(seconds * 60) {}
+			Seconds(uint64_t seconds) : Time(seconds * ticksPerSecond) {}
 		};
 		
 		class Frames : public Time
@@ -52,6 +62,28 @@ namespace Engine
 	class Screen
 	{
 	public:
+		//time spent in each phase of the game loop in microseconds, accumulated until reset
+		struct PhaseTimings
+		{
+			sf::Int64 events = 0; //EveryFrame and event dispatch
+			sf::Int64 movement = 0;
+			sf::Int64 collision = 0;
+			sf::Int64 removal = 0;
+			sf::Int64 draw = 0;
+			sf::Int64 frame = 0; //whole rendered frames, excluding the wait for the next frame
+			uint64_t collisionPairsTested = 0; //unordered pairs sharing a grid cell
+			uint64_t collisionPairsHit = 0; //pairs where either side reported a collision
+			uint64_t steps = 0;
+			uint64_t renderedFrames = 0;
+			uint64_t spritesBatched = 0;
+			uint64_t spriteBatchDrawCalls = 0;
+			uint64_t objectsDrawn = 0; //world objects inside the view
+			uint64_t objectsCulled = 0; //world objects skipped because they were outside the view
+			uint64_t flowFieldRebuilds = 0;
+			uint64_t eventsDispatched = 0; //handler calls, one per subscribed object per event
+			uint64_t mouseMovesCoalesced = 0; //MouseMoved events dropped because a later one in the same step replaced them
+		};
+
 		Screen();
 		~Screen();
 		void addMap(TileMap* map);
@@ -60,24 +92,146 @@ namespace Engine
 		void addUIObject(GameObject* uiObj);
 		bool find(GameObject* gameObject);
 		void remove(GameObject* gameObject, bool autoDelete = true);
-		void schedule(function<void()> func, TimeUnit::Time delay, uint16_t repeatCount = 1);
+		void updateEventSubscriptions(GameObject* gameObject); //puts an object on the subscriber lists of the event groups it subscribes to, does nothing if it is not on this screen
+		//calls func after delay + 1 steps, then every delay + 1 steps for repeatCount more calls, a repeatCount of 0 repeats until cancelled
+		TimerWheel::Handle schedule(function<void()> func, TimeUnit::Time delay, uint16_t repeatCount = 1);
+		bool cancel(TimerWheel::Handle handle); //returns false if the timer already finished or was cancelled
 		void render();
+		uint64_t runHeadless(uint64_t frames, InputSource* input = nullptr, sf::RenderWindow* drawTarget = nullptr);
 		void close();
 		sf::Vector2i getMousePosition() const;
 		GraphicalGameObject* getMainCharacter() const;
 		const TileMap* getMap() const;
+		const FlowField& getPlayerFlowField(); //steps toward the main character, rebuilt when the main character moves to another tile
+		sf::Vector2f getMainCharacterPosition() const;
+		//neighbourhood queries over every object with Collision, answered from the grid built after the last movement pass
+		//T filters the results, e.g. queryRadius<Enemy> or nearest<Mage>, GameObject matches everything
+		//objects added since the last simulation step are not found yet and objects removed since are skipped
+		template<typename T> void queryRect(sf::FloatRect rect, vector<T*>& results) const;
+		template<typename T> void queryRadius(sf::Vector2f center, float radius, vector<T*>& results) const;
+		template<typename T> T* nearest(sf::Vector2f point, float maxDistance = std::numeric_limits<float>::infinity(), const GameObject* exclude = nullptr) const;
 		unsigned static int windowWidth;
 		unsigned static int windowHeight;
 		static const char* windowTitle;
+		unsigned static int frameRate;
+		static FramePacer::Mode framePacingMode;
+		static const PhaseTimings& getPhaseTimings();
+		static void resetPhaseTimings();
 	private:
-		unordered_map<GameObjectID, GameObject*> allObjects;
-		unordered_map<GameObjectID, GraphicalGameObject*> renderObjects;
-		unordered_map<GameObjectID, GraphicalGameObject*> uiObjects;
-		unordered_map<GameObjectID, GameObjectAttribute::Collision*> collisionObjects;
-		unordered_map<GameObjectID, GameObjectAttribute::Movement*> movingObjectsWithTerrainCollision;
-		unordered_map<GameObjectID, GameObjectAttribute::Movement*> movingObjects;
+		void update(uint64_t frameNumber);
+		void updateMovement();
+		void updateCollisions();
+		void processRemoveQueue();
+		void removeNow(GameObject* gameObject, bool autoDelete);
+		void eraseEventSubscriptions(GameObjectID id);
+		static void coalesceMouseMoves(vector<sf::Event>& events);
+		void draw(sf::RenderWindow& window, sf::View& view, float interpolation);
+		void updateView(sf::View& view) const;
+		//capabilities are resolved once when an object is added so the per frame passes need no casts
+		//attributes an object has, so queries only cast the objects that can match
+		enum AttributeFlag : uint8_t
+		{
+			HealthFlag = 1,
+			MovementFlag = 2,
+			TerrainCollisionFlag = 4,
+			EnemyFlag = 8,
+			AttackerFlag = 16,
+			HealerFlag = 32,
+			SpriteSheetFlag = 64
+		};
+		static uint8_t attributeFlagsOf(GameObject* gameObject);
+		template<typename T> static constexpr uint8_t attributeFlagsOf();
+		struct CollisionEntry
+		{
+			GameObjectAttribute::Collision* collision;
+			sf::Sprite* sprite;
+			GameObject* object;
+			GameObjectID id;
+			uint8_t attributes;
+		};
+		template<typename T> T* matchQuery(const CollisionEntry& entry) const;
+		struct MovingEntry
+		{
+			GameObjectAttribute::Movement* movement;
+			GameObjectAttribute::TerrainCollision* terrainCollision; //nullptr if the object ignores terrain
+			sf::Sprite* sprite;
+		};
+		struct RenderEntry
+		{
+			GraphicalGameObject* object;
+			sf::Sprite* sprite; //nullptr if the graphic is not a sprite, those objects are never batched
+			sf::Shape* shape; //culling uses the sprite's or shape's bounds, objects with neither are always drawn
+		};
+		struct UIEntry
+		{
+			GraphicalGameObject* object;
+			sf::Transformable* transformable;
+		};
+		DenseObjectMap<GameObject*> allObjects;
+		DenseObjectMap<RenderEntry> renderObjects;
+		SpriteBatch spriteBatch;
+		vector<GraphicalGameObject*> unbatchedObjects;
+		vector<std::pair<sf::Sprite*, sf::Vector2f>> interpolatedSprites; //simulated positions to restore after a draw, per screen since a draw can render another screen
+		DenseObjectMap<UIEntry> uiObjects;
+		DenseObjectMap<CollisionEntry> collisionObjects;
+		DenseObjectMap<MovingEntry> movingObjectsWithTerrainCollision;
+		DenseObjectMap<MovingEntry> movingObjects;
+		SpatialGrid<CollisionEntry> collisionGrid; //also the index for the spatial queries
+		vector<sf::Event> pendingEvents;
+		static constexpr int eventGroupCount = 8;
+		DenseObjectMap<GameObject*> eventSubscribers[eventGroupCount]; //one list per GameObject::EventGroup bit
+		vector<GameObject*> dispatchSnapshot; //kept between updates so dispatching allocates nothing once it has grown
 		GraphicalGameObject* mainCharacter = nullptr;
+		sf::Sprite* mainCharacterSprite = nullptr;
+		FlowField playerFlowField;
+		TimerWheel timers;
 		TileMap* tMap = nullptr;
 	};
+
+	template<typename T> constexpr uint8_t Screen::attributeFlagsOf()
+	{
+		return (std::is_base_of<GameObjectAttribute::Health, T>::value ? HealthFlag : 0)
+			| (std::is_base_of<GameObjectAttribute::Movement, T>::value ? MovementFlag : 0)
+			| (std::is_base_of<GameObjectAttribute::TerrainCollision, T>::value ? TerrainCollisionFlag : 0)
+			| (std::is_base_of<GameObjectAttribute::Enemy, T>::value ? EnemyFlag : 0)
+			| (std::is_base_of<GameObjectAttribute::Attacker, T>::value ? AttackerFlag : 0)
+			| (std::is_base_of<GameObjectAttribute::Healer, T>::value ? HealerFlag : 0)
+			| (std::is_base_of<GameObjectAttribute::SpriteSheet, T>::value ? SpriteSheetFlag : 0);
+	}
+
+	template<typename T> T* Screen::matchQuery(const CollisionEntry& entry) const
+	{
+		//the grid is not rebuilt when objects are removed, so entries for removed (and possibly deleted) objects are skipped by id
+		constexpr uint8_t required = attributeFlagsOf<T>();
+		if ((entry.attributes & required) != required || !this->collisionObjects.contains(entry.id)) { return nullptr; }
+		return dynamic_cast<T*>(entry.object);
+	}
+
+	template<typename T> void Screen::queryRect(sf::FloatRect rect, vector<T*>& results) const
+	{
+		results.clear();
+		this->collisionGrid.forEachInRect(rect, [&](const CollisionEntry& entry, const sf::FloatRect&)
+		{
+			if (T* match = this->matchQuery<T>(entry)) { results.push_back(match); }
+		});
+	}
+
+	template<typename T> void Screen::queryRadius(sf::Vector2f center, float radius, vector<T*>& results) const
+	{
+		results.clear();
+		this->collisionGrid.forEachInRadius(center, radius, [&](const CollisionEntry& entry, const sf::FloatRect&)
+		{
+			if (T* match = this->matchQuery<T>(entry)) { results.push_back(match); }
+		});
+	}
+
+	template<typename T> T* Screen::nearest(sf::Vector2f point, float maxDistance, const GameObject* exclude) const
+	{
+		const CollisionEntry* found = this->collisionGrid.nearest(point, maxDistance, [&](const CollisionEntry& entry)
+		{
+			return entry.object != exclude && this->matchQuery<T>(entry) != nullptr;
+		});
+		return (found != nullptr) ? dynamic_cast<T*>(found->object) : nullptr;
+	}
 }
 #endif
\ No newline at end of file
@@ -4,15 +4,19 @@
 #include "SFML/Audio.hpp"
 #include "FileLoadException.h"
 #include "ResourceManager.h"
+#include "ResourcePreloader.h"
 #include "Screen.h"
 #include <list>
 #include <map>
+#include <array>
+#include <iterator>
 #include <thread>
 
 using std::map;
 using std::list;
 using std::string;
 using Engine::ResourceManager;
+using Engine::ResourceHandle;
 
 namespace Engine
 {
@@ -35,74 +39,113 @@ namespace Engine
 			Potion,
 			Trap,
 			Alarm,
-			MenuClick
+			MenuClick,
+			Count //number of ids, not a sound
 		};
 	}
 
 	class SoundPlayer : private sf::NonCopyable
 	{
 	private:
-		static list<sf::Sound>& getSoundList()
+		//the handle keeps the buffer from being evicted while the sound plays, it is declared first so it outlives the sound
+		struct PlayingSound
 		{
-			static list<sf::Sound> soundList;
+			ResourceHandle<sf::SoundBuffer> buffer;
+			sf::Sound sound;
+		};
+
+		static list<PlayingSound>& getSoundList()
+		{
+			static list<PlayingSound> soundList;
 			return soundList;
 		}
 
-		static map<SoundEffect::ID, string>& getIDMap()
+		//finished sounds are kept here and reused, so playing a sound allocates nothing once enough have played at the same time
+		static list<PlayingSound>& getIdleSounds()
+		{
+			static list<PlayingSound> idleSounds;
+			return idleSounds;
+		}
+
+		static constexpr size_t effectCount = static_cast<size_t>(SoundEffect::ID::Count);
+
+		//the interned key of each effect's file, indexed by id
+		static std::array<ResourceManager<sf::SoundBuffer>::Key, effectCount>& getKeys()
 		{
-			static map<SoundEffect::ID, string> idMap;
-			return idMap;
+			static std::array<ResourceManager<sf::SoundBuffer>::Key, effectCount> keys;
+			return keys;
 		}
 
 		static void initializeIDMap()
 		{
 			static bool initialized = false;
 			if (initialized) { return; }
-			map<SoundEffect::ID, string>& idMap = getIDMap();
-			idMap[SoundEffect::ID::ZombieEat1] = "zombie_eat1.ogg";
-			idMap[SoundEffect::ID::ZombieEat2] = "zombie_eat2.ogg";
-			idMap[SoundEffect::ID::ZombieEat3] = "zombie_eat3.ogg";
-			idMap[SoundEffect::ID::ZombieBurp1] = "zombie_burp1.ogg";
-			idMap[SoundEffect::ID::ZombieBurp2] = "zombie_burp2.ogg";
-			idMap[SoundEffect::ID::ZombieBurp3] = "zombie_burp3.ogg";
-			idMap[SoundEffect::ID::ZombieBurp4] = "zombie_burp4.ogg";
-			idMap[SoundEffect::ID::ZombieAttack] = "zombie_attack.ogg";
-			idMap[SoundEffect::ID::ZombieGroan] = "zombie_hurt.ogg";
-			idMap[SoundEffect::ID::ZombieDeath] = "zombie_death.ogg";
-			idMap[SoundEffect::ID::MageDeath] = "mage_death.ogg";
-			idMap[SoundEffect::ID::Potion] = "potion.ogg";
-			idMap[SoundEffect::ID::Trap] = "trap.ogg";
-			idMap[SoundEffect::ID::Alarm] = "alarm.ogg";
-			idMap[SoundEffect::ID::MenuClick] = "menu_buttonclick.ogg";
+			std::array<string, effectCount> idMap;
+			idMap[static_cast<size_t>(SoundEffect::ID::ZombieEat1)] = "zombie_eat1.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::ZombieEat2)] = "zombie_eat2.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::ZombieEat3)] = "zombie_eat3.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::ZombieBurp1)] = "zombie_burp1.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::ZombieBurp2)] = "zombie_burp2.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::ZombieBurp3)] = "zombie_burp3.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::ZombieBurp4)] = "zombie_burp4.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::ZombieAttack)] = "zombie_attack.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::ZombieGroan)] = "zombie_hurt.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::ZombieDeath)] = "zombie_death.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::MageDeath)] = "mage_death.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::Potion)] = "potion.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::Trap)] = "trap.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::Alarm)] = "alarm.ogg";
+			idMap[static_cast<size_t>(SoundEffect::ID::MenuClick)] = "menu_buttonclick.ogg";
+			for (size_t i = 0; i < effectCount; i++) { getKeys()[i] = ResourceManager<sf::SoundBuffer>::Intern(idMap[i]); }
 			initialized = true;
 		}
 	public:
 
-		static void preloadSounds()
+		//decodes every sound effect in the background, playing one that is not ready yet only waits for that one
+		static void preloadSounds(ResourcePreloader& preloader)
 		{
-			for (auto iter : getIDMap())
+			initializeIDMap();
+			for (auto key : getKeys())
 			{
-				ResourceManager<sf::SoundBuffer>::GetResource(iter.second);
+				preloader.add<sf::SoundBuffer>(ResourceManager<sf::SoundBuffer>::GetFilename(key));
 			}
 		}
 
-		static void play(string effectFileName, float volume)
+		static void play(const string& effectFileName, float volume)
 		{
-			sf::Sound sound = sf::Sound(*ResourceManager<sf::SoundBuffer>::GetResource(effectFileName));
-			list<sf::Sound>& soundList = getSoundList();
-			soundList.push_back(sound);
-			soundList.back().setVolume(volume);
-			soundList.back().play();
-			soundList.remove_if([](const sf::Sound& s) { return s.getStatus() == sf::Sound::Stopped; });
+			play(ResourceManager<sf::SoundBuffer>::AcquireResource(effectFileName), volume);
 		}
 
+		//an array lookup, no strings are built or hashed
 		static void play(SoundEffect::ID effect, float volume)
 		{
 			initializeIDMap();
-			map<SoundEffect::ID, string>& idMap = getIDMap();
-			auto iter = idMap.find(effect);
-			if (iter == idMap.end()) { return; }
-			play((*iter).second, volume);
+			if (static_cast<size_t>(effect) >= effectCount) { return; }
+			play(ResourceManager<sf::SoundBuffer>::AcquireResource(getKeys()[static_cast<size_t>(effect)]), volume);
+		}
+
+	private:
+		static void play(ResourceHandle<sf::SoundBuffer> buffer, float volume)
+		{
+			list<PlayingSound>& soundList = getSoundList();
+			list<PlayingSound>& idleSounds = getIdleSounds();
+			for (auto iter = soundList.begin(); iter != soundList.end();)
+			{
+				auto next = std::next(iter);
+				if ((*iter).sound.getStatus() == sf::Sound::Stopped)
+				{
+					(*iter).buffer = ResourceHandle<sf::SoundBuffer>();
+					idleSounds.splice(idleSounds.begin(), soundList, iter);
+				}
+				iter = next;
+			}
+			if (idleSounds.empty()) { idleSounds.emplace_back(); }
+			soundList.splice(soundList.end(), idleSounds, idleSounds.begin());
+			PlayingSound& playing = soundList.back();
+			playing.buffer = buffer;
+			playing.sound.setBuffer(*playing.buffer);
+			playing.sound.setVolume(volume);
+			playing.sound.play();
 		}
 	};
 }
@@ -0,0 +1,257 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include "SFML/Graphics.hpp"
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+namespace Engine
+{
+	//uniform grid which buckets objects by every cell their bounding box overlaps
+	//T is stored by value, so it should be a pointer or a small struct
+	template<typename T> class SpatialGrid
+	{
+	public:
+		SpatialGrid(sf::Vector2u cellSize = sf::Vector2u(64U, 64U))
+		{
+			this->setCellSize(cellSize);
+		}
+
+		void setCellSize(sf::Vector2u cellSize)
+		{
+			this->cellWidth = static_cast<float>((cellSize.x > 0U) ? cellSize.x : 1U);
+			this->cellHeight = static_cast<float>((cellSize.y > 0U) ? cellSize.y : 1U);
+			this->cells.clear();
+			this->clear();
+		}
+
+		//empties every cell but keeps their storage so rebuilding each frame does not reallocate
+		void clear()
+		{
+			for (auto const & cell : this->occupiedCells) { cell.second->clear(); }
+			this->occupiedCells.clear();
+			this->entries.clear();
+			this->minCell = sf::Vector2i(0, 0);
+			this->maxCell = sf::Vector2i(-1, -1);
+		}
+
+		void insert(const T& object, sf::FloatRect bounds)
+		{
+			size_t index = this->entries.size();
+			this->entries.push_back({ object, bounds });
+			int left = this->cellX(bounds.left);
+			int top = this->cellY(bounds.top);
+			int right = this->cellX(bounds.left + bounds.width);
+			int bottom = this->cellY(bounds.top + bounds.height);
+			if (index == 0)
+			{
+				this->minCell = sf::Vector2i(left, top);
+				this->maxCell = sf::Vector2i(right, bottom);
+			}
+			else
+			{
+				this->minCell = sf::Vector2i(std::min(left, this->minCell.x), std::min(top, this->minCell.y));
+				this->maxCell = sf::Vector2i(std::max(right, this->maxCell.x), std::max(bottom, this->maxCell.y));
+			}
+			for (int x = left; x <= right; x++)
+			{
+				for (int y = top; y <= bottom; y++)
+				{
+					int64_t key = cellKey(x, y);
+					std::vector<size_t>& cell = this->cells[key];
+					if (cell.empty()) { this->occupiedCells.push_back({ key, &cell }); }
+					cell.push_back(index);
+				}
+			}
+		}
+
+		//calls func(a, b) exactly once for every unordered pair of objects whose bounding boxes intersect
+		template<typename Func> void forEachOverlappingPair(Func func) const
+		{
+			for (auto const & cell : this->occupiedCells)
+			{
+				const std::vector<size_t>& indices = *cell.second;
+				for (size_t i = 0; i < indices.size(); i++)
+				{
+					const Entry& a = this->entries[indices[i]];
+					for (size_t j = i + 1; j < indices.size(); j++)
+					{
+						const Entry& b = this->entries[indices[j]];
+						if (!a.bounds.intersects(b.bounds)) { continue; }
+						//a pair sharing several cells is only reported from the cell holding the top left corner of their overlap
+						float overlapLeft = (a.bounds.left > b.bounds.left) ? a.bounds.left : b.bounds.left;
+						float overlapTop = (a.bounds.top > b.bounds.top) ? a.bounds.top : b.bounds.top;
+						if (cellKey(this->cellX(overlapLeft), this->cellY(overlapTop)) != cell.first) { continue; }
+						func(a.object, b.object);
+					}
+				}
+			}
+		}
+
+		//calls func(object, bounds) exactly once for every object whose bounding box intersects rect
+		template<typename Func> void forEachInRect(sf::FloatRect rect, Func func) const
+		{
+			this->visitRect(rect, false, func);
+		}
+
+		//calls func(object, bounds) exactly once for every object whose bounding box comes within radius of center
+		template<typename Func> void forEachInRadius(sf::Vector2f center, float radius, Func func) const
+		{
+			float radiusSquared = radius * radius;
+			//a box exactly radius away only touches the square around the circle, so touching boxes are visited too
+			this->visitRect(sf::FloatRect(center.x - radius, center.y - radius, radius * 2.f, radius * 2.f), true, [&](const T& object, const sf::FloatRect& bounds)
+			{
+				if (distanceSquared(center, bounds) <= radiusSquared) { func(object, bounds); }
+			});
+		}
+
+		//the object closest to point for which accept(object) is true, nullptr if none is within maxDistance
+		//distance is measured to the object's bounding box, cells are searched in rings around the point's cell until no unsearched cell can hold anything closer
+		template<typename Accept> const T* nearest(sf::Vector2f point, float maxDistance, Accept accept) const
+		{
+			if (this->entries.empty()) { return nullptr; }
+			const T* best = nullptr;
+			float bestDistanceSquared = maxDistance * maxDistance;
+			int originX = this->cellX(point.x);
+			int originY = this->cellY(point.y);
+			float ringWidth = (this->cellWidth < this->cellHeight) ? this->cellWidth : this->cellHeight;
+			int maxRing = std::max(std::max(originX - this->minCell.x, this->maxCell.x - originX), std::max(originY - this->minCell.y, this->maxCell.y - originY));
+			auto visitCell = [&](int x, int y)
+			{
+				if (x < this->minCell.x || x > this->maxCell.x || y < this->minCell.y || y > this->maxCell.y) { return; }
+				auto iter = this->cells.find(cellKey(x, y));
+				if (iter == this->cells.end()) { return; }
+				for (size_t index : iter->second)
+				{
+					const Entry& entry = this->entries[index];
+					float distance = distanceSquared(point, entry.bounds);
+					if (distance > bestDistanceSquared || (best != nullptr && distance == bestDistanceSquared)) { continue; }
+					if (!accept(entry.object)) { continue; }
+					best = &entry.object;
+					bestDistanceSquared = distance;
+				}
+			};
+			for (int ring = 0; ring <= maxRing; ring++)
+			{
+				//the point is at least this far from every cell in this ring and beyond
+				float ringDistance = static_cast<float>(ring - 1) * ringWidth;
+				if (ring > 0 && ringDistance * ringDistance > bestDistanceSquared) { break; }
+				if (ring == 0)
+				{
+					visitCell(originX, originY);
+					continue;
+				}
+				for (int x = originX - ring; x <= originX + ring; x++)
+				{
+					visitCell(x, originY - ring);
+					visitCell(x, originY + ring);
+				}
+				for (int y = originY - ring + 1; y <= originY + ring - 1; y++)
+				{
+					visitCell(originX - ring, y);
+					visitCell(originX + ring, y);
+				}
+			}
+			return best;
+		}
+
+		size_t size() const
+		{
+			return this->entries.size();
+		}
+
+	private:
+		struct Entry
+		{
+			T object;
+			sf::FloatRect bounds;
+		};
+
+		//touching also reports boxes that only share an edge with rect, which intersects leaves out
+		template<typename Func> void visitRect(const sf::FloatRect& rect, bool touching, Func func) const
+		{
+			if (this->entries.empty()) { return; }
+			int left = std::max(this->cellX(rect.left), this->minCell.x);
+			int top = std::max(this->cellY(rect.top), this->minCell.y);
+			int right = std::min(this->cellX(rect.left + rect.width), this->maxCell.x);
+			int bottom = std::min(this->cellY(rect.top + rect.height), this->maxCell.y);
+			if (left > right || top > bottom) { return; }
+			auto visitCell = [&](int64_t key, const std::vector<size_t>& indices)
+			{
+				for (size_t index : indices)
+				{
+					const Entry& entry = this->entries[index];
+					if (touching ? !touches(entry.bounds, rect) : !entry.bounds.intersects(rect)) { continue; }
+					//an object in several cells is only reported from the cell holding the top left corner of its overlap with rect
+					float overlapLeft = (entry.bounds.left > rect.left) ? entry.bounds.left : rect.left;
+					float overlapTop = (entry.bounds.top > rect.top) ? entry.bounds.top : rect.top;
+					if (cellKey(this->cellX(overlapLeft), this->cellY(overlapTop)) != key) { continue; }
+					func(entry.object, entry.bounds);
+				}
+			};
+			//rects covering more cells than are occupied walk the occupied cells instead of looking each covered cell up
+			size_t coveredCells = static_cast<size_t>(right - left + 1) * static_cast<size_t>(bottom - top + 1);
+			if (coveredCells > this->occupiedCells.size())
+			{
+				for (auto const & cell : this->occupiedCells)
+				{
+					int x = static_cast<int>(cell.first >> 32);
+					int y = static_cast<int>(static_cast<uint32_t>(cell.first));
+					if (x >= left && x <= right && y >= top && y <= bottom) { visitCell(cell.first, *cell.second); }
+				}
+				return;
+			}
+			for (int x = left; x <= right; x++)
+			{
+				for (int y = top; y <= bottom; y++)
+				{
+					int64_t key = cellKey(x, y);
+					auto iter = this->cells.find(key);
+					if (iter != this->cells.end()) { visitCell(key, iter->second); }
+				}
+			}
+		}
+
+		static bool touches(const sf::FloatRect& a, const sf::FloatRect& b)
+		{
+			return a.left <= b.left + b.width && b.left <= a.left + a.width && a.top <= b.top + b.height && b.top <= a.top + a.height;
+		}
+
+		//0 if the point is inside the rect
+		static float distanceSquared(sf::Vector2f point, const sf::FloatRect& rect)
+		{
+			float dx = (point.x < rect.left) ? rect.left - point.x : ((point.x > rect.left + rect.width) ? point.x - rect.left - rect.width : 0.f);
+			float dy = (point.y < rect.top) ? rect.top - point.y : ((point.y > rect.top + rect.height) ? point.y - rect.top - rect.height : 0.f);
+			return dx * dx + dy * dy;
+		}
+
+		int cellX(float x) const
+		{
+			return static_cast<int>(std::floor(x / this->cellWidth));
+		}
+
+		int cellY(float y) const
+		{
+			return static_cast<int>(std::floor(y / this->cellHeight));
+		}
+
+		static int64_t cellKey(int x, int y)
+		{
+			//shifted as unsigned, shifting a negative x is undefined
+			return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y));
+		}
+
+		float cellWidth;
+		float cellHeight;
+		std::vector<Entry> entries;
+		std::unordered_map<int64_t, std::vector<size_t>> cells;
+		std::vector<std::pair<int64_t, std::vector<size_t>*>> occupiedCells;
+		sf::Vector2i minCell = sf::Vector2i(0, 0); //extent of the occupied cells, nothing is occupied while max is below min
+		sf::Vector2i maxCell = sf::Vector2i(-1, -1);
+	};
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include "SFML/Graphics.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine
+{
+	//collects textured sprites into one quad array per texture so each texture costs a single draw call
+	//sprites sharing a texture are drawn in the order they were added, different textures in the order they first appeared
+	class SpriteBatch
+	{
+	public:
+		//returns false if the sprite has no texture, the caller should draw it itself
+		bool add(const sf::Sprite& sprite)
+		{
+			const sf::Texture* texture = sprite.getTexture();
+			if (texture == nullptr) { return false; }
+			sf::VertexArray& quads = this->quadsFor(texture);
+
+			sf::FloatRect bounds = sprite.getLocalBounds();
+			sf::IntRect rect = sprite.getTextureRect();
+			const sf::Transform& transform = sprite.getTransform();
+			const sf::Color& color = sprite.getColor();
+			float left = static_cast<float>(rect.left);
+			float top = static_cast<float>(rect.top);
+			float right = left + static_cast<float>(rect.width);
+			float bottom = top + static_cast<float>(rect.height);
+			quads.append(sf::Vertex(transform.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top)));
+			quads.append(sf::Vertex(transform.transformPoint(bounds.width, 0.f), color, sf::Vector2f(right, top)));
+			quads.append(sf::Vertex(transform.transformPoint(bounds.width, bounds.height), color, sf::Vector2f(right, bottom)));
+			quads.append(sf::Vertex(transform.transformPoint(0.f, bounds.height), color, sf::Vector2f(left, bottom)));
+			this->spriteCount++;
+			return true;
+		}
+
+		//draws every texture's quads and empties the batch, the vertex storage is kept for the next frame
+		void flush(sf::RenderTarget& target)
+		{
+			for (const sf::Texture* texture : this->textureOrder)
+			{
+				sf::VertexArray& quads = this->batches[texture];
+				target.draw(quads, sf::RenderStates(texture));
+				quads.clear();
+				this->drawCalls++;
+			}
+			this->textureOrder.clear();
+		}
+
+		uint64_t getSpriteCount() const
+		{
+			return this->spriteCount;
+		}
+
+		uint64_t getDrawCalls() const
+		{
+			return this->drawCalls;
+		}
+
+		void resetStatistics()
+		{
+			this->spriteCount = 0;
+			this->drawCalls = 0;
+		}
+
+	private:
+		sf::VertexArray& quadsFor(const sf::Texture* texture)
+		{
+			auto iter = this->batches.find(texture);
+			if (iter == this->batches.end()) { iter = this->batches.emplace(texture, sf::VertexArray(sf::Quads)).first; }
+			if (iter->second.getVertexCount() == 0) { this->textureOrder.push_back(texture); }
+			return iter->second;
+		}
+
+		std::unordered_map<const sf::Texture*, sf::VertexArray> batches;
+		std::vector<const sf::Texture*> textureOrder;
+		uint64_t spriteCount = 0;
+		uint64_t drawCalls = 0;
+	};
+}
+
+#endif
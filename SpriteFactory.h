@@ -3,8 +3,11 @@
 
 #include "SFML/Graphics.hpp"
 #include "ResourceManager.h"
+#include "ResourcePreloader.h"
+#include "TextureAtlas.h"
 #include <string>
 #include <map>
+#include <array>
 #include <vector>
 #include <cstdlib>
 #include <ctime>
@@ -54,79 +57,176 @@ namespace Engine
 			Tutorial,
 			Woman,
 			XButton,
-			Zombie
+			Zombie,
+			Count //number of ids, not a sprite
 		};
 	}
 
 	class SpriteFactory
 	{
 	public:
-		static sf::Sprite generateSprite(string textureFilename)
+		//images packed into the atlas come back as a sub rect of the shared atlas texture
+		static sf::Sprite generateSprite(const string& textureFilename)
 		{
+			initializeMap();
+			if (const TextureAtlas::Region* region = getAtlas().find(textureFilename)) { return sf::Sprite(*region->texture, region->rect); }
 			sf::Texture* texturePtr = ResourceManager<sf::Texture>::GetResource(textureFilename);
 			sf::Sprite sprite;
 			sprite.setTexture(*texturePtr);
 			return sprite;
 		}
 
+		//an array lookup, the texture or atlas region behind each id is found on its first use
+		//an image outside the atlas keeps its texture cached through the factory's own handle, so it is never evicted
 		static sf::Sprite generateSprite(Sprite::ID id)
+		{
+			if (static_cast<size_t>(id) >= spriteCount) { return sf::Sprite(); }
+			return generateSprite(id, getSource(id).texture);
+		}
+
+		//like generateSprite(id), but texture is set to the handle keeping an image outside the atlas cached
+		//the caller holds it for as long as the sprite is drawn, after that the texture can be evicted, texture is empty for atlas images
+		static sf::Sprite generateSprite(Sprite::ID id, ResourceHandle<sf::Texture>& texture)
 		{
 			initializeMap();
-			map<Sprite::ID, string>& idMap = getIDMap();
-			auto pair = idMap.find(id);
-			if (pair == idMap.end()) { return sf::Sprite(); }
-			return generateSprite((*pair).second);
+			if (static_cast<size_t>(id) >= spriteCount) { return sf::Sprite(); }
+			SpriteSource& source = getSource(id);
+			if (!source.resolved)
+			{
+				if (const TextureAtlas::Region* region = getAtlas().find(source.filename)) { source.atlasRegion = *region; }
+				else { source.textureKey = ResourceManager<sf::Texture>::Intern(source.filename); }
+				source.resolved = true;
+			}
+			if (source.atlasRegion.texture)
+			{
+				texture = ResourceHandle<sf::Texture>();
+				return sf::Sprite(*source.atlasRegion.texture, source.atlasRegion.rect);
+			}
+			texture = ResourceManager<sf::Texture>::AcquireResource(source.textureKey);
+			return sf::Sprite(*texture);
+		}
+
+		//queues the sprite's texture on the preloader, images packed into the atlas are loaded by preloadAtlas instead
+		static void preload(Sprite::ID id, ResourcePreloader& preloader)
+		{
+			initializeSources();
+			if (static_cast<size_t>(id) >= spriteCount || isPackedInAtlas(id)) { return; }
+			preloader.add<sf::Texture>(getSource(id).filename);
+		}
+
+		//starts decoding the atlas images on the loader threads and counts them on the preloader
+		//the first sprite generated after the preloader is done only packs and uploads the atlas pages
+		static void preloadAtlas(ResourcePreloader& preloader)
+		{
+			initializeSources();
+			TextureAtlas& atlas = getAtlas();
+			atlas.startLoads();
+			for (auto const & load : atlas.getLoads()) { preloader.addJob(load.filename, load.ticket); }
 		}
 
 	private:
+		//builds the atlas the first time a sprite is generated
 		static void initializeMap()
 		{
 			static bool mapInitialized = false;
 			if (mapInitialized) { return; }
-			map<Sprite::ID, string>& idMap = getIDMap();
-			idMap[Sprite::ID::AnimatedPotion] = "animated_potion.png";
-			idMap[Sprite::ID::AntimagePotion] = "antimage_potion.png";
-			idMap[Sprite::ID::Blast] = "blast.png";
-			idMap[Sprite::ID::Bloodyhands] = "bloodyhands.png";
-			idMap[Sprite::ID::BookButton] = "book_button.png";
-			idMap[Sprite::ID::Boy] = "boy.png";
-			idMap[Sprite::ID::Brain] = "brain.png";
-			idMap[Sprite::ID::BrainIcon] = "brain_icon.png";
-			idMap[Sprite::ID::Bullet] = "bullet.png";
-			idMap[Sprite::ID::EasyButton] = "easy_button.png";
-			idMap[Sprite::ID::Gameover] = "gameover.png";
-			idMap[Sprite::ID::GameoverBack] = "gameover_back.png";
-			idMap[Sprite::ID::Girl] = "girl.png";
-			idMap[Sprite::ID::Guardian] = "guardian.png";
-			idMap[Sprite::ID::InsaneButton] = "insane_button.png";
-			idMap[Sprite::ID::Mage] = "mage.png";
-			idMap[Sprite::ID::Mageblast] = "mageblast.png";
-			idMap[Sprite::ID::Man] = "man.png";
-			idMap[Sprite::ID::MenuBackground] = "menu_background.png";
-			idMap[Sprite::ID::MenuEasy] = "menu_easy.png";
-			idMap[Sprite::ID::MenuEscape] = "menu_escape.png";
-			idMap[Sprite::ID::MenuInsane] = "menu_insane.png";
-			idMap[Sprite::ID::MenuNormal] = "menu_normal.png";
-			idMap[Sprite::ID::MenuScore] = "menu_score.png";
-			idMap[Sprite::ID::MenuTutorial] = "menu_tutorial.png";
-			idMap[Sprite::ID::NormalButton] = "normal_button.png";
-			idMap[Sprite::ID::Oldman] = "oldman.png";
-			idMap[Sprite::ID::Oldwoman] = "oldwoman.png";
-			idMap[Sprite::ID::Scoreboard] = "scoreboard.png";
-			idMap[Sprite::ID::Story] = "story.png";
-			idMap[Sprite::ID::SuperZombieBlast] = "super_zombie_blast.png";
-			idMap[Sprite::ID::Tileset] = "tileset.png";
-			idMap[Sprite::ID::Tutorial] = "tutorial.png";
-			idMap[Sprite::ID::Woman] = "woman.png";
-			idMap[Sprite::ID::XButton] = "x_button.png";
-			idMap[Sprite::ID::Zombie] = "zombie.png";
+			initializeSources();
+			getAtlas().build();
 			mapInitialized = true;
 		}
 
-		static map<Sprite::ID, string>& getIDMap()
+		static void initializeSources()
+		{
+			static bool sourcesInitialized = false;
+			if (sourcesInitialized) { return; }
+			getSource(Sprite::ID::AnimatedPotion).filename = "animated_potion.png";
+			getSource(Sprite::ID::AntimagePotion).filename = "antimage_potion.png";
+			getSource(Sprite::ID::Blast).filename = "blast.png";
+			getSource(Sprite::ID::Bloodyhands).filename = "bloodyhands.png";
+			getSource(Sprite::ID::BookButton).filename = "book_button.png";
+			getSource(Sprite::ID::Boy).filename = "boy.png";
+			getSource(Sprite::ID::Brain).filename = "brain.png";
+			getSource(Sprite::ID::BrainIcon).filename = "brain_icon.png";
+			getSource(Sprite::ID::Bullet).filename = "bullet.png";
+			getSource(Sprite::ID::EasyButton).filename = "easy_button.png";
+			getSource(Sprite::ID::Gameover).filename = "gameover.png";
+			getSource(Sprite::ID::GameoverBack).filename = "gameover_back.png";
+			getSource(Sprite::ID::Girl).filename = "girl.png";
+			getSource(Sprite::ID::Guardian).filename = "guardian.png";
+			getSource(Sprite::ID::InsaneButton).filename = "insane_button.png";
+			getSource(Sprite::ID::Mage).filename = "mage.png";
+			getSource(Sprite::ID::Mageblast).filename = "mageblast.png";
+			getSource(Sprite::ID::Man).filename = "man.png";
+			getSource(Sprite::ID::MenuBackground).filename = "menu_background.png";
+			getSource(Sprite::ID::MenuEasy).filename = "menu_easy.png";
+			getSource(Sprite::ID::MenuEscape).filename = "menu_escape.png";
+			getSource(Sprite::ID::MenuInsane).filename = "menu_insane.png";
+			getSource(Sprite::ID::MenuNormal).filename = "menu_normal.png";
+			getSource(Sprite::ID::MenuScore).filename = "menu_score.png";
+			getSource(Sprite::ID::MenuTutorial).filename = "menu_tutorial.png";
+			getSource(Sprite::ID::NormalButton).filename = "normal_button.png";
+			getSource(Sprite::ID::Oldman).filename = "oldman.png";
+			getSource(Sprite::ID::Oldwoman).filename = "oldwoman.png";
+			getSource(Sprite::ID::Scoreboard).filename = "scoreboard.png";
+			getSource(Sprite::ID::Story).filename = "story.png";
+			getSource(Sprite::ID::SuperZombieBlast).filename = "super_zombie_blast.png";
+			getSource(Sprite::ID::Tileset).filename = "tileset.png";
+			getSource(Sprite::ID::Tutorial).filename = "tutorial.png";
+			getSource(Sprite::ID::Woman).filename = "woman.png";
+			getSource(Sprite::ID::XButton).filename = "x_button.png";
+			getSource(Sprite::ID::Zombie).filename = "zombie.png";
+			sourcesInitialized = true;
+
+			TextureAtlas& atlas = getAtlas();
+			for (size_t i = 0; i < spriteCount; i++)
+			{
+				if (isPackedInAtlas(static_cast<Sprite::ID>(i))) { atlas.add(getSources()[i].filename); }
+			}
+		}
+
+		//the tileset is drawn by TileMap straight from its own texture
+		//the full screen images are too large for an atlas page, leaving them out here saves decoding them twice
+		static bool isPackedInAtlas(Sprite::ID id)
+		{
+			switch (id)
+			{
+			case Sprite::ID::Tileset:
+			case Sprite::ID::MenuBackground:
+			case Sprite::ID::Scoreboard:
+			case Sprite::ID::Story:
+			case Sprite::ID::Tutorial:
+				return false;
+			default:
+				return true;
+			}
+		}
+
+		static TextureAtlas& getAtlas()
+		{
+			static TextureAtlas atlas;
+			return atlas;
+		}
+
+		static constexpr size_t spriteCount = static_cast<size_t>(Sprite::ID::Count);
+
+		struct SpriteSource
+		{
+			string filename;
+			bool resolved = false;
+			TextureAtlas::Region atlasRegion = { nullptr, sf::IntRect() }; //texture is nullptr if the image is not in the atlas
+			ResourceManager<sf::Texture>::Key textureKey = 0; //used when the image is not in the atlas
+			ResourceHandle<sf::Texture> texture; //set once generateSprite(id) is used without a handle of the caller's
+		};
+
+		static std::array<SpriteSource, spriteCount>& getSources()
+		{
+			static std::array<SpriteSource, spriteCount> sources;
+			return sources;
+		}
+
+		static SpriteSource& getSource(Sprite::ID id)
 		{
-			static map<Sprite::ID, string> idMap;
-			return idMap;
+			return getSources()[static_cast<size_t>(id)];
 		}
 	};
 }
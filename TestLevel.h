@@ -8,6 +8,8 @@
 #include "FileLoadException.h"
 #include "ResourceManager.h"
 #include "SpriteFactory.h"
+#include "SoundPlayer.h"
+#include "ResourcePreloader.h"
 
 using namespace Engine;
 
@@ -16,10 +18,35 @@ class TestLevel
 public:
 	TestLevel() {}
 
+	//starts loading everything the current difficulty's level needs on the loader threads
+	//called when a difficulty is picked, so the files load while the player types a name
+	static ResourcePreloader& preload()
+	{
+		ResourcePreloader& preloader = getPreloader();
+		preloader.clear();
+		preloader.add<sf::Texture>(DifficultySettings::Map::picture);
+		preloader.addMappedFile(DifficultySettings::Map::fileName);
+		for (Sprite::ID id : { Sprite::ID::Zombie, Sprite::ID::BrainIcon, Sprite::ID::Boy, Sprite::ID::Girl, Sprite::ID::Man, Sprite::ID::Woman,
+			Sprite::ID::Oldman, Sprite::ID::Oldwoman, Sprite::ID::Mage, Sprite::ID::Mageblast, Sprite::ID::Blast, Sprite::ID::Brain,
+			Sprite::ID::AnimatedPotion, Sprite::ID::Gameover, Sprite::ID::GameoverBack })
+		{
+			SpriteFactory::preload(id, preloader);
+		}
+		preloader.add<sf::Font>("zombie.ttf");
+		SoundPlayer::preloadSounds(preloader);
+		return preloader;
+	}
+
 	void start(std::string playerName)
 	{
 		static Screen* oldScreen = nullptr;
 
+		//whatever preload started and has not finished yet is waited for here instead of being loaded again
+		getPreloader().wait();
+		ResourceManager<sf::Texture>::ReportCacheStatistics();
+		ResourceManager<sf::SoundBuffer>::ReportCacheStatistics();
+		ResourceManager<sf::Font>::ReportCacheStatistics();
+
 		Screen* levelScreen = new Screen();
 		static TileMap map;
 
@@ -94,6 +121,13 @@ public:
 
 		levelScreen->render();
 	}
+
+private:
+	static ResourcePreloader& getPreloader()
+	{
+		static ResourcePreloader preloader;
+		return preloader;
+	}
 };
 
 #endif
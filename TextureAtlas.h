@@ -0,0 +1,157 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "SFML/Graphics.hpp"
+#include "FileLoadException.h"
+#include "DebugManager.h"
+#include "AssetLoader.h"
+#include "AssetArchive.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine
+{
+	//packs many small images from data/ into a few large textures so sprites using them can share a texture
+	//images are placed on shelves, tallest first, a new page is started when one fills up
+	class TextureAtlas
+	{
+	public:
+		struct Region
+		{
+			const sf::Texture* texture;
+			sf::IntRect rect;
+		};
+
+		//an image being decoded on the loader threads, the ticket is done once the image is in memory
+		struct Load
+		{
+			std::string filename;
+			AssetLoader::Ticket ticket;
+		};
+
+		//queues an image for packing, build() has to be called before it can be found
+		void add(const std::string& filename)
+		{
+			this->pending.push_back(filename);
+		}
+
+		//starts decoding every queued image on the loader threads, build() packs them once they are all decoded
+		void startLoads()
+		{
+			for (auto const & filename : this->pending)
+			{
+				if (this->regions.find(filename) != this->regions.end()) { continue; }
+				std::shared_ptr<Decoded> decoded = std::make_shared<Decoded>();
+				AssetLoader::Ticket ticket = AssetLoader::submit([decoded, filename]() { decoded->loaded = AssetArchive::loadResource(filename, decoded->image); }, []() {});
+				this->loads.push_back({ filename, ticket });
+				this->decoded.push_back(decoded);
+			}
+			this->pending.clear();
+		}
+
+		//the images startLoads has started and build has not packed yet
+		const std::vector<Load>& getLoads() const
+		{
+			return this->loads;
+		}
+
+		//loads and packs every queued image, images bigger than half a page are left out and keep their own texture
+		//images startLoads already decoded are only packed, the packed pages are uploaded on the calling thread
+		void build(unsigned int pageSize = 2048U)
+		{
+			unsigned int maxSize = sf::Texture::getMaximumSize();
+			if (pageSize > maxSize) { pageSize = maxSize; }
+
+			//every decode is waited for before anything can throw, a decode no loader thread has picked up yet runs here
+			this->startLoads();
+			for (auto const & load : this->loads) { AssetLoader::wait(load.ticket); }
+
+			std::vector<std::pair<std::string, sf::Image>> images;
+			for (size_t i = 0; i < this->loads.size(); i++)
+			{
+				const std::string& filename = this->loads[i].filename;
+				if (!this->decoded[i]->loaded) { throw GameException::DataFileLoadException(filename); }
+				sf::Vector2u size = this->decoded[i]->image.getSize();
+				if (size.x + padding > pageSize / 2 || size.y + padding > pageSize / 2)
+				{
+					DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, std::string("Image \"") + filename + std::string("\" is too large for the texture atlas."));
+					continue;
+				}
+				images.push_back({ filename, std::move(this->decoded[i]->image) });
+			}
+			this->loads.clear();
+			this->decoded.clear();
+			std::stable_sort(images.begin(), images.end(), [](auto const & a, auto const & b) { return a.second.getSize().y > b.second.getSize().y; });
+
+			sf::Image page;
+			std::vector<std::pair<std::string, sf::IntRect>> placed;
+			unsigned int x = 0U;
+			unsigned int y = 0U;
+			unsigned int shelfHeight = 0U;
+			auto finishPage = [&]()
+			{
+				if (placed.empty()) { return; }
+				std::unique_ptr<sf::Texture> texture(new sf::Texture());
+				texture->loadFromImage(page);
+				for (auto const & region : placed) { this->regions[region.first] = { texture.get(), region.second }; }
+				this->pages.push_back(std::move(texture));
+				placed.clear();
+			};
+			for (auto const & image : images)
+			{
+				sf::Vector2u size = image.second.getSize();
+				if (x + size.x + padding > pageSize)
+				{
+					x = 0U;
+					y += shelfHeight;
+					shelfHeight = 0U;
+				}
+				if (y + size.y + padding > pageSize)
+				{
+					finishPage();
+					x = 0U;
+					y = 0U;
+					shelfHeight = 0U;
+				}
+				if (placed.empty()) { page.create(pageSize, pageSize, sf::Color::Transparent); }
+				page.copy(image.second, x + padding, y + padding);
+				placed.push_back({ image.first, sf::IntRect(static_cast<int>(x + padding), static_cast<int>(y + padding), static_cast<int>(size.x), static_cast<int>(size.y)) });
+				x += size.x + padding;
+				if (size.y + padding > shelfHeight) { shelfHeight = size.y + padding; }
+			}
+			finishPage();
+		}
+
+		//returns nullptr if the image was not packed
+		const Region* find(const std::string& filename) const
+		{
+			auto iter = this->regions.find(filename);
+			return (iter != this->regions.end()) ? &iter->second : nullptr;
+		}
+
+		size_t getPageCount() const
+		{
+			return this->pages.size();
+		}
+
+	private:
+		//written by a loader thread, read once the load's ticket is done
+		struct Decoded
+		{
+			sf::Image image;
+			bool loaded = false;
+		};
+
+		static constexpr unsigned int padding = 2U; //transparent gap between images so filtering never samples a neighbour
+		std::vector<std::string> pending;
+		std::vector<Load> loads;
+		std::vector<std::shared_ptr<Decoded>> decoded; //one per load
+		std::vector<std::unique_ptr<sf::Texture>> pages;
+		std::unordered_map<std::string, Region> regions;
+	};
+}
+
+#endif
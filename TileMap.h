@@ -4,9 +4,13 @@
 #include "SFML/Graphics.hpp"
 #include "FileLoadException.h"
 #include "ResourceManager.h"
+#include "BinaryMap.h"
+#include "MappedFile.h"
+#include "AssetArchive.h"
 #include <iostream>
-#include <fstream>
 #include <cstdlib>
+#include <cmath>
+#include <algorithm>
 
 #define F(n) static_cast<float>(n)
 #define I(n) static_cast<int>(n)
@@ -20,56 +24,77 @@ namespace Engine
 		sf::Vector2u tileStdSize;
 		unsigned int numPerLine;
 		unsigned int numPerColumn;
-		int* tiles;
-		sf::VertexArray mVertices;
-		sf::Texture* mTileset;
+		//the map's tiles, flags and spawn positions live in a binary image, mapped straight from a binary map file
+		//or encoded into ownedImage when the map is loaded from the text format
+		MappedFile mappedFile;
+		std::vector<uint8_t> ownedImage;
+		BinaryMap mapData;
+		const uint8_t* tileFlags = nullptr;
+		ResourceHandle<sf::Texture> mTileset; //keeps the map picture cached while the map uses it
+
+		//the map is drawn in square chunks of tiles, each chunk's geometry is built the first time it is visible
+		//and uploaded once to a static vertex buffer, or kept in a vertex array if the driver has no vertex buffers
+		struct Chunk
+		{
+			sf::VertexBuffer buffer = sf::VertexBuffer(sf::Quads, sf::VertexBuffer::Static);
+			sf::VertexArray vertices = sf::VertexArray(sf::Quads);
+			bool built = false;
+		};
+		static constexpr unsigned int chunkSize = 32;
+		unsigned int chunksPerLine = 0;
+		mutable std::vector<Chunk> chunks;
+
 		virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const
 		{
 			// apply the transform
 			states.transform *= getTransform();
 
 			// apply the tileset texture
-			states.texture = mTileset;
-
-			// draw the vertex array
-			target.draw(mVertices, states);
-		}
-		sf::Vector2i positionToRowAndColumn(sf::Vector2f position) const
-		{
-			return sf::Vector2i( I(position.x / F(this->tileSize().x)), I(position.y / F(this->tileSize().y)) );
+			states.texture = mTileset.get();
+
+			// draw only the chunks the view can see
+			sf::IntRect range = this->visibleTileRange(target.getView());
+			if (range.width <= 0 || range.height <= 0) { return; }
+			unsigned int firstX = static_cast<unsigned int>(range.left) / chunkSize;
+			unsigned int firstY = static_cast<unsigned int>(range.top) / chunkSize;
+			unsigned int lastX = static_cast<unsigned int>(range.left + range.width - 1) / chunkSize;
+			unsigned int lastY = static_cast<unsigned int>(range.top + range.height - 1) / chunkSize;
+			for (unsigned int cy = firstY; cy <= lastY; ++cy)
+			{
+				for (unsigned int cx = firstX; cx <= lastX; ++cx)
+				{
+					Chunk& chunk = this->chunks[cx + cy * this->chunksPerLine];
+					if (!chunk.built) { this->buildChunk(chunk, cx, cy); }
+					if (chunk.buffer.getVertexCount() > 0) { target.draw(chunk.buffer, states); }
+					else { target.draw(chunk.vertices, states); }
+				}
+			}
 		}
-	public:
 
-		bool load(const std::string& tileset, const std::string& mapTable)
+		void buildChunk(Chunk& chunk, unsigned int cx, unsigned int cy) const
 		{
-			// load the tileset texture
-			this->mTileset = ResourceManager<sf::Texture>::GetResource(tileset);
-
-			int * tileTable;
-			tileTable = readFromFile(mapTable);
-
-			this->tiles = tileTable;
-			// resize the vertex array to fit the level size
-			mVertices.setPrimitiveType(sf::Quads);
-			mVertices.resize(numPerLine * numPerColumn * 4);
-
-			// populate the vertex array, with one quad per tile
-			for (unsigned int i = 0; i < numPerLine; ++i)
+			unsigned int firstI = cx * chunkSize;
+			unsigned int firstJ = cy * chunkSize;
+			unsigned int lastI = std::min(firstI + chunkSize, this->numPerLine);
+			unsigned int lastJ = std::min(firstJ + chunkSize, this->numPerColumn);
+			unsigned int tilesPerTextureRow = this->mTileset->getSize().x / this->tileStdSize.x;
+
+			chunk.vertices.resize((lastI - firstI) * (lastJ - firstJ) * 4);
+			std::size_t quadIndex = 0;
+			for (unsigned int j = firstJ; j < lastJ; ++j)
 			{
-				for (unsigned int j = 0; j < numPerColumn; ++j)
+				for (unsigned int i = firstI; i < lastI; ++i)
 				{
-					// get the current tile number
-					int tileNumber = tiles[i + j * numPerLine];
-
-					// find its position in the tileset texture
-					int tu = tileNumber % (mTileset->getSize().x / this->tileStdSize.x);
-					int tv = tileNumber / (mTileset->getSize().x / this->tileStdSize.x);
+					// find the tile's position in the tileset texture
+					int tileNumber = this->mapData.tile(i + j * this->numPerLine);
+					int tu = tileNumber % I(tilesPerTextureRow);
+					int tv = tileNumber / I(tilesPerTextureRow);
 
 					// get a pointer to the current tile's quad
-					sf::Vertex* quad = &mVertices[(i + j * numPerLine) * 4];
+					sf::Vertex* quad = &chunk.vertices[quadIndex * 4];
+					quadIndex++;
 
 					// define its 4 corners
-
 					quad[0].position = sf::Vector2f(F(i * this->tileStdSize.x), F(j * this->tileStdSize.y));
 					quad[1].position = sf::Vector2f(F((i + 1) * this->tileStdSize.x), F(j * this->tileStdSize.y));
 					quad[2].position = sf::Vector2f(F((i + 1) * this->tileStdSize.x), F((j + 1) * this->tileStdSize.y));
@@ -83,63 +108,138 @@ namespace Engine
 				}
 			}
 
-			//initialize safe spawn positions
-			for (unsigned int i = 1; i < this->numPerLine - 1; i++)
+			if (sf::VertexBuffer::isAvailable() && chunk.buffer.create(chunk.vertices.getVertexCount()) && chunk.buffer.update(&chunk.vertices[0]))
 			{
-				for (unsigned int j = 1; j < this->numPerColumn - 1; j++)
-				{
-					bool anyObstacles = false;
-					for (auto tile : {
-						this->getTileAt(i - 1, j - 1),
-						this->getTileAt(i - 1, j),
-						this->getTileAt(i, j - 1),
-						this->getTileAt(i + 1, j + 1),
-						this->getTileAt(i + 1, j),
-						this->getTileAt(i, j + 1),
-						this->getTileAt(i - 1, j + 1),
-						this->getTileAt(i + 1, j - 1)
-						})
-					{
-						if (isTileTypeObstacle(tile))
-						{
-							anyObstacles = true;
-							break;
-						}
-					}
-					if (!anyObstacles)
-					{
-						sf::Vector2f pos = this->getTileCenter(i, j);
-						this->safeSpawnPositions.push_back(pos);
-					}
-				}
+				chunk.vertices.clear();
 			}
+			chunk.built = true;
+		}
+
+		sf::Vector2i positionToRowAndColumn(sf::Vector2f position) const
+		{
+			return sf::Vector2i( I(position.x / F(this->tileSize().x)), I(position.y / F(this->tileSize().y)) );
+		}
+	public:
+		//columns and rows of tiles overlapping the view, clamped to the map
+		sf::IntRect visibleTileRange(const sf::View& view) const
+		{
+			if (this->tileStdSize.x == 0 || this->tileStdSize.y == 0) { return sf::IntRect(0, 0, 0, 0); }
+			sf::FloatRect viewRect(view.getCenter() - view.getSize() / 2.f, view.getSize());
+			viewRect = this->getInverseTransform().transformRect(viewRect);
+			int left = std::max(0, I(std::floor(viewRect.left / F(this->tileStdSize.x))));
+			int top = std::max(0, I(std::floor(viewRect.top / F(this->tileStdSize.y))));
+			int right = std::min(I(this->numPerLine), I(std::ceil((viewRect.left + viewRect.width) / F(this->tileStdSize.x))));
+			int bottom = std::min(I(this->numPerColumn), I(std::ceil((viewRect.top + viewRect.height) / F(this->tileStdSize.y))));
+			if (right <= left || bottom <= top) { return sf::IntRect(0, 0, 0, 0); }
+			return sf::IntRect(left, top, right - left, bottom - top);
+		}
+
+		bool load(const std::string& tileset, const std::string& mapTable)
+		{
+			// load the tileset texture
+			this->mTileset = ResourceManager<sf::Texture>::AcquireResource(tileset);
+
+			this->readFromFile(mapTable);
+
+			// the chunks are built when they are first drawn
+			this->chunksPerLine = (this->numPerLine + chunkSize - 1) / chunkSize;
+			unsigned int chunksPerColumn = (this->numPerColumn + chunkSize - 1) / chunkSize;
+			this->chunks.clear();
+			this->chunks.resize(this->chunksPerLine * chunksPerColumn);
 
 			return true;
 		}
 
-		static bool isTileTypeObstacle(int tileType)
+		//TileProperties flags of a cell, everything off the map counts as an out of bounds obstacle
+		uint8_t getFlagsAtCell(int i, int j) const
+		{
+			if (static_cast<unsigned int>(i) >= this->numPerLine || static_cast<unsigned int>(j) >= this->numPerColumn) { return TileProperties::Obstacle | TileProperties::OutOfBounds; }
+			return this->tileFlags[static_cast<unsigned int>(i) + static_cast<unsigned int>(j) * this->numPerLine];
+		}
+
+		uint8_t getFlagsAt(sf::Vector2f position) const
+		{
+			return this->getFlagsAtCell(this->positionToRowAndColumn(position));
+		}
+
+		uint8_t getFlagsAtCell(sf::Vector2i rowAndColumn) const
 		{
-			return (tileType < 0 || tileType == 0 || tileType == 1 || tileType == 2 || tileType == 9 || tileType == 10 || tileType == 11 || tileType == 18 || tileType == 19 || tileType == 20);
+			return this->getFlagsAtCell(rowAndColumn.x, rowAndColumn.y);
 		}
 
-		static bool isTileTypeTrap(int tileType)
+		//how far the box can move along one axis, up to delta, before it enters a cell with any of the blocking flags
+		//only the cells the leading edge sweeps over are checked, so fast objects cannot skip a wall and large boxes cannot straddle one
+		//cells the box already overlaps are ignored, which lets an object that starts inside a wall move out of it
+		float sweepAxis(const sf::FloatRect& box, float delta, bool horizontal, uint8_t blockingFlags) const
 		{
-			return (tileType == 6 || tileType == 7 || tileType == 8 || tileType == 15 || tileType == 16 || tileType == 17 || tileType == 25 || tileType == 26);
+			if (delta == 0.f) { return 0.f; }
+			const float epsilon = 0.001f; //boxes touching a cell edge do not overlap the cell
+			float tileAlong = F(horizontal ? this->tileStdSize.x : this->tileStdSize.y);
+			float tileAcross = F(horizontal ? this->tileStdSize.y : this->tileStdSize.x);
+			float start = horizontal ? box.left : box.top;
+			float size = horizontal ? box.width : box.height;
+			float across = horizontal ? box.top : box.left;
+			float acrossSize = horizontal ? box.height : box.width;
+			int firstAcross = I(std::floor((across + epsilon) / tileAcross));
+			int lastAcross = I(std::ceil((across + acrossSize - epsilon) / tileAcross)) - 1;
+
+			auto blocked = [&](int cell)
+			{
+				for (int other = firstAcross; other <= lastAcross; other++)
+				{
+					uint8_t flags = horizontal ? this->getFlagsAtCell(cell, other) : this->getFlagsAtCell(other, cell);
+					if (flags & blockingFlags) { return true; }
+				}
+				return false;
+			};
+
+			if (delta > 0.f)
+			{
+				float leading = start + size;
+				int last = I(std::ceil((leading + delta - epsilon) / tileAlong)) - 1;
+				for (int cell = I(std::ceil((leading - epsilon) / tileAlong)); cell <= last; cell++)
+				{
+					if (blocked(cell)) { return std::max(0.f, F(cell) * tileAlong - leading); }
+				}
+			}
+			else
+			{
+				float leading = start;
+				int last = I(std::floor((leading + delta + epsilon) / tileAlong));
+				for (int cell = I(std::floor((leading + epsilon) / tileAlong)) - 1; cell >= last; cell--)
+				{
+					if (blocked(cell)) { return std::min(0.f, F(cell + 1) * tileAlong - leading); }
+				}
+			}
+			return delta;
 		}
-		
+
 		bool isOutOfBounds(sf::Vector2f position) const
 		{
-			return this->getTileAt(this->positionToRowAndColumn(position)) < 0;
+			return (this->getFlagsAt(position) & TileProperties::OutOfBounds) != 0;
 		}
 
 		bool isObstacle(sf::Vector2f position) const
 		{
-			return isTileTypeObstacle(this->getTileAt(this->positionToRowAndColumn(position)));
+			return (this->getFlagsAt(position) & TileProperties::Obstacle) != 0;
 		}
 
 		bool isTrap(sf::Vector2f position) const
 		{
-			return isTileTypeTrap(this->getTileAt(this->positionToRowAndColumn(position)));
+			return (this->getFlagsAt(position) & TileProperties::Trap) != 0;
+		}
+
+		//tile type properties for text maps, binary maps carry their flags precomputed
+		static const TileProperties& getTileProperties()
+		{
+			static TileProperties properties;
+			static bool loaded = false;
+			if (!loaded)
+			{
+				if (!properties.loadFromFile("data/tile_properties.txt")) { throw GameException::DataFileLoadException("tile_properties.txt"); }
+				loaded = true;
+			}
+			return properties;
 		}
 
 		sf::Vector2f getTileCenter(int i, int j) const
@@ -167,10 +267,22 @@ namespace Engine
 			return this->tileStdSize;
 		}
 
+		//index into the map's tiles, -1 for the first row and column and anything past the edges
+		int tileIndex(int i, int j) const
+		{
+			if (i < 1 || j < 1 || i >= I(this->width()) || j >= I(this->height())) { return -1; }
+			return i + j * I(this->width());
+		}
+
+		int tileIndex(sf::Vector2i rowAndColumn) const
+		{
+			return this->tileIndex(rowAndColumn.x, rowAndColumn.y);
+		}
+
 		int getTileAt(int i, int j) const
 		{
-			if (i < 1 || j < 1 || i > I(this->width()) || j > I(this->height())) { return -1; }			
-			return this->tiles[i + j * I(this->width())];
+			int index = this->tileIndex(i, j);
+			return (index < 0) ? -1 : this->mapData.tile(static_cast<size_t>(index));
 		}
 
 		int getTileAt(sf::Vector2i rowAndColumn) const
@@ -178,24 +290,61 @@ namespace Engine
 			return this->getTileAt(rowAndColumn.x, rowAndColumn.y);
 		}
 
-		int* readFromFile(std::string mapTable)
+		//reads either map format, binary maps are used in place and text maps are encoded to the binary layout
+		//a map in data/ is read from the mounted AssetArchive if the archive has it
+		void readFromFile(const std::string& mapTable)
 		{
-			std::ifstream fin(mapTable.c_str());
-			if (!fin) { throw GameException::DataFileLoadException(mapTable); }
+			this->ownedImage.clear();
+			this->mappedFile.close();
+			const uint8_t* data;
+			size_t size;
+			if (mapTable.compare(0, 5, "data/") != 0 || !AssetArchive::findMounted(mapTable.substr(5), data, size))
+			{
+				if (!this->mappedFile.open(mapTable)) { throw GameException::DataFileLoadException(mapTable); }
+				data = this->mappedFile.data();
+				size = this->mappedFile.size();
+			}
+			bool valid;
+			if (BinaryMap::isBinary(data, size))
+			{
+				valid = this->mapData.view(data, size);
+			}
+			else
+			{
+				this->ownedImage = BinaryMap::encodeText(reinterpret_cast<const char*>(data), size, getTileProperties());
+				this->mappedFile.close();
+				valid = this->mapData.view(this->ownedImage.data(), this->ownedImage.size());
+			}
+			if (!valid) { throw GameException::DataFileLoadException(mapTable); }
+			this->useMapData();
+		}
 
-			//read width and size from the file
-			fin >> this->numPerLine;
-			fin >> this->numPerColumn;
-			fin >> this->tileStdSize.x;
-			fin >> this->tileStdSize.y;
+		//takes a binary map image built in memory, such as one from BinaryMap::encode, for tools and tests
+		//there is no tileset, so the map can be queried but not drawn
+		//returns false if the image is not a valid binary map
+		bool readFromMemory(std::vector<uint8_t> image)
+		{
+			this->mappedFile.close();
+			this->ownedImage = std::move(image);
+			if (!this->mapData.view(this->ownedImage.data(), this->ownedImage.size())) { return false; }
+			this->useMapData();
+			return true;
+		}
 
-			//determine the size of the array
-			int size = this->numPerColumn * this->numPerLine;
-			int *tileTable = nullptr; // pointer to int
-			tileTable = new int[size];
-			for (int i = 0; i < size; i++) { fin >> tileTable[i]; }
-			fin.close();
-			return tileTable;
+	private:
+		void useMapData()
+		{
+			this->numPerLine = this->mapData.width();
+			this->numPerColumn = this->mapData.height();
+			this->tileStdSize = sf::Vector2u(this->mapData.tileWidth(), this->mapData.tileHeight());
+			this->tileFlags = this->mapData.flags();
+			this->safeSpawnPositions.clear();
+			for (uint32_t i = 0; i < this->mapData.spawnCount(); i++)
+			{
+				sf::Vector2f pos;
+				this->mapData.getSpawn(i, pos.x, pos.y);
+				this->safeSpawnPositions.push_back(pos);
+			}
 		}
 	};
 }
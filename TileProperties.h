@@ -0,0 +1,70 @@
+#ifndef TILE_PROPERTIES_H
+#define TILE_PROPERTIES_H
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Engine
+{
+	//what each tile type in the tileset does, read from a text file with one property per line followed by the tile types that have it:
+	//obstacle 0 1 2
+	//trap 6 7
+	//lines starting with # are comments
+	class TileProperties
+	{
+	public:
+		enum Flag : uint8_t
+		{
+			Obstacle = 1,
+			Trap = 2,
+			OutOfBounds = 4, //only set on map cells, never by the properties file
+			Spawnable = 8 //only set on map cells, for tiles with no obstacle around them
+		};
+
+		bool loadFromFile(const std::string& filename)
+		{
+			std::ifstream fin(filename.c_str());
+			if (!fin) { return false; }
+			return this->loadFromStream(fin);
+		}
+
+		bool loadFromStream(std::istream& in)
+		{
+			this->flags.clear();
+			std::string line;
+			while (std::getline(in, line))
+			{
+				std::istringstream words(line);
+				std::string property;
+				if (!(words >> property) || property[0] == '#') { continue; }
+				uint8_t flag;
+				if (property == "obstacle") { flag = Obstacle; }
+				else if (property == "trap") { flag = Trap; }
+				else { return false; }
+				int tileType;
+				while (words >> tileType)
+				{
+					if (tileType < 0) { return false; }
+					if (static_cast<size_t>(tileType) >= this->flags.size()) { this->flags.resize(static_cast<size_t>(tileType) + 1, 0); }
+					this->flags[static_cast<size_t>(tileType)] |= flag;
+				}
+			}
+			return true;
+		}
+
+		//tile types below zero are the out of bounds marker, types the file never mentions have no properties
+		uint8_t flagsFor(int tileType) const
+		{
+			if (tileType < 0) { return Obstacle | OutOfBounds; }
+			return (static_cast<size_t>(tileType) < this->flags.size()) ? this->flags[static_cast<size_t>(tileType)] : 0;
+		}
+
+	private:
+		std::vector<uint8_t> flags;
+	};
+}
+
+#endif
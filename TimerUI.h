@@ -13,15 +13,16 @@ using namespace Engine;
 class TimerUI : public GraphicalGameObject
 {
 private:
-	sf::Text* text() { return dynamic_cast<sf::Text*>(this->getGraphic()); }
+	sf::Text* text() { return this->getText(); }
+	ResourceHandle<sf::Font> font;
 	MainCharacter* character = nullptr;
 	int minute;
 	int second;
 public:
 	TimerUI(sf::Text t) : GraphicalGameObject(t)
 	{
-		sf::Font* fontPtr = ResourceManager<sf::Font>::GetResource("zombie.ttf");
-		this->text()->setFont(*fontPtr);
+		this->font = ResourceManager<sf::Font>::AcquireResource("zombie.ttf");
+		this->text()->setFont(*this->font);
 		this->text()->setStyle(sf::Text::Bold);
 		this->text()->setOutlineColor(sf::Color(179, 45, 0));
 		this->text()->setOutlineThickness(2.f);
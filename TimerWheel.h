@@ -0,0 +1,216 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Engine
+{
+	//hierarchical timer wheel counting in simulation steps
+	//each level has 64 slots, a timer goes in the lowest level whose span covers its delay and moves down a level each time the level below wraps
+	//a step only touches the slot that is due and, every 64 steps, the slot being moved down, so waiting timers cost nothing
+	class TimerWheel
+	{
+	public:
+		//identifies a scheduled timer, 0 is never a valid handle
+		typedef uint64_t Handle;
+
+		TimerWheel()
+		{
+			this->slots.assign(levels * slotsPerLevel, none);
+		}
+
+		//calls func after delay + 1 steps, then every delay + 1 steps for repeatCount more calls, a repeatCount of 0 repeats forever
+		Handle schedule(std::function<void()> func, uint64_t delay, uint32_t repeatCount)
+		{
+			int32_t index;
+			if (this->freeNodes.empty())
+			{
+				index = static_cast<int32_t>(this->nodes.size());
+				this->nodes.push_back(Node());
+			}
+			else
+			{
+				index = this->freeNodes.back();
+				this->freeNodes.pop_back();
+			}
+			Node& node = this->nodes[static_cast<size_t>(index)];
+			node.func = std::move(func);
+			node.period = delay + 1;
+			node.expiry = this->currentStep + node.period;
+			node.repeatsRemaining = repeatCount;
+			node.infinite = (repeatCount == 0);
+			node.scheduled = true;
+			this->insert(index);
+			this->activeCount++;
+			return (static_cast<Handle>(node.generation) << 32) | static_cast<Handle>(index + 1);
+		}
+
+		//returns false if the timer already finished or was cancelled
+		bool cancel(Handle handle)
+		{
+			int32_t index = this->find(handle);
+			if (index < 0) { return false; }
+			if (index == this->firingNode)
+			{
+				this->firingCancelled = true;
+				return true;
+			}
+			this->unlink(index);
+			this->release(index);
+			return true;
+		}
+
+		bool isScheduled(Handle handle) const
+		{
+			int32_t index = this->find(handle);
+			return index >= 0 && !(index == this->firingNode && this->firingCancelled);
+		}
+
+		//moves time forward one step and calls every timer that is due
+		void advance()
+		{
+			this->currentStep++;
+			//timers on higher levels are moved down before the levels below them are emptied
+			int highest = 0;
+			for (int level = 1; level < levels; level++)
+			{
+				if ((this->currentStep & ((uint64_t(1) << (slotBits * level)) - 1)) != 0) { break; }
+				highest = level;
+			}
+			for (int level = highest; level > 0; level--)
+			{
+				int32_t& head = this->slotHead(level, this->slotIndex(this->currentStep, level));
+				while (head != none)
+				{
+					int32_t index = head;
+					this->unlink(index);
+					this->insert(index);
+				}
+			}
+
+			//a callback can schedule more timers, but never into this slot, so it is emptied one timer at a time
+			int32_t& due = this->slotHead(0, this->slotIndex(this->currentStep, 0));
+			while (due != none)
+			{
+				int32_t index = due;
+				this->unlink(index);
+				this->firingNode = index;
+				this->firingCancelled = false;
+				//the node storage can grow while the callback runs, so the callback is moved out of it first
+				std::function<void()> func = std::move(this->nodes[static_cast<size_t>(index)].func);
+				func();
+				this->firingNode = none;
+				Node& node = this->nodes[static_cast<size_t>(index)];
+				if (!this->firingCancelled && (node.infinite || node.repeatsRemaining > 0))
+				{
+					if (!node.infinite) { node.repeatsRemaining--; }
+					node.func = std::move(func);
+					node.expiry = this->currentStep + node.period;
+					this->insert(index);
+				}
+				else { this->release(index); }
+			}
+		}
+
+		size_t size() const
+		{
+			return this->activeCount;
+		}
+
+		uint64_t getCurrentStep() const
+		{
+			return this->currentStep;
+		}
+
+	private:
+		static constexpr int slotBits = 6;
+		static constexpr int slotsPerLevel = 1 << slotBits;
+		static constexpr int levels = 4; //spans 2^24 steps, longer delays wait in the top level and are placed again each time it wraps
+		static constexpr int32_t none = -1;
+
+		struct Node
+		{
+			std::function<void()> func;
+			uint64_t expiry = 0;
+			uint64_t period = 0;
+			uint32_t repeatsRemaining = 0;
+			uint32_t generation = 0;
+			int32_t prev = none;
+			int32_t next = none;
+			int32_t slot = none;
+			bool infinite = false;
+			bool scheduled = false;
+		};
+
+		static int slotIndex(uint64_t step, int level)
+		{
+			return static_cast<int>((step >> (slotBits * level)) & (slotsPerLevel - 1));
+		}
+
+		int32_t& slotHead(int level, int slot)
+		{
+			return this->slots[static_cast<size_t>(level * slotsPerLevel + slot)];
+		}
+
+		int32_t find(Handle handle) const
+		{
+			uint64_t index = (handle & 0xFFFFFFFFULL);
+			if (index == 0 || index > this->nodes.size()) { return none; }
+			const Node& node = this->nodes[static_cast<size_t>(index - 1)];
+			if (!node.scheduled || node.generation != static_cast<uint32_t>(handle >> 32)) { return none; }
+			return static_cast<int32_t>(index - 1);
+		}
+
+		void insert(int32_t index)
+		{
+			Node& node = this->nodes[static_cast<size_t>(index)];
+			uint64_t delta = node.expiry - this->currentStep;
+			uint64_t target = node.expiry;
+			int level = 0;
+			while (level < levels - 1 && delta >= (uint64_t(1) << (slotBits * (level + 1)))) { level++; }
+			if (delta >= (uint64_t(1) << (slotBits * levels))) { target = this->currentStep + (uint64_t(1) << (slotBits * levels)) - 1; }
+			int32_t slot = level * slotsPerLevel + slotIndex(target, level);
+			int32_t& head = this->slots[static_cast<size_t>(slot)];
+			node.slot = slot;
+			node.prev = none;
+			node.next = head;
+			if (head != none) { this->nodes[static_cast<size_t>(head)].prev = index; }
+			head = index;
+		}
+
+		void unlink(int32_t index)
+		{
+			Node& node = this->nodes[static_cast<size_t>(index)];
+			if (node.slot == none) { return; }
+			if (node.prev != none) { this->nodes[static_cast<size_t>(node.prev)].next = node.next; }
+			else { this->slots[static_cast<size_t>(node.slot)] = node.next; }
+			if (node.next != none) { this->nodes[static_cast<size_t>(node.next)].prev = node.prev; }
+			node.prev = none;
+			node.next = none;
+			node.slot = none;
+		}
+
+		void release(int32_t index)
+		{
+			Node& node = this->nodes[static_cast<size_t>(index)];
+			node.func = nullptr;
+			node.scheduled = false;
+			node.generation++;
+			this->freeNodes.push_back(index);
+			this->activeCount--;
+		}
+
+		std::vector<Node> nodes;
+		std::vector<int32_t> freeNodes;
+		std::vector<int32_t> slots; //head of each slot's list of nodes, levels * slotsPerLevel of them
+		uint64_t currentStep = 0;
+		size_t activeCount = 0;
+		int32_t firingNode = none;
+		bool firingCancelled = false;
+	};
+}
+
+#endif
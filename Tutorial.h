@@ -12,6 +12,8 @@ using namespace Engine;
 class Tutorial : public GraphicalGameObject
 {
 private:
+	ResourceHandle<sf::Texture> storyTexture; //declared before the sprites, the full screen images are not in the atlas
+	ResourceHandle<sf::Texture> tutorialTexture;
 	sf::Sprite story;
 	sf::Sprite tutorial;
 	sf::Sprite bookButton;
@@ -23,11 +25,12 @@ private:
 public:
 	Tutorial()
 		: GraphicalGameObject(sf::Sprite()),
-		story(SpriteFactory::generateSprite(Sprite::ID::Story)),
-		tutorial(SpriteFactory::generateSprite(Sprite::ID::Tutorial)),
+		story(SpriteFactory::generateSprite(Sprite::ID::Story, this->storyTexture)),
+		tutorial(SpriteFactory::generateSprite(Sprite::ID::Tutorial, this->tutorialTexture)),
 		bookButton(SpriteFactory::generateSprite(Sprite::ID::BookButton)),
 		xButton(SpriteFactory::generateSprite(Sprite::ID::XButton))
 	{
+		this->subscribeEvents(MouseButtonEvents);
 		this->bookButton.setPosition(Screen::windowWidth - 280.f, Screen::windowHeight - 260.f);
 		this->xButton.setPosition(Screen::windowWidth - 55.f, 15.f);
 		for (auto obj : Menu::getCurrentMenu()->getMenuObjects()) { if (obj != this) { obj->disableEvents(); } }
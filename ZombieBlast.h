@@ -4,6 +4,7 @@
 #include "Screen.h"
 #include "SpriteFactory.h"
 #include "GameObjectAttribute.h"
+#include "ObjectPool.h"
 #include <cmath>
 #include <string>
 
@@ -25,27 +26,53 @@ protected:
 	int damage = 1;
 	float growRate;
 	float growth = 1.f;
-public:
+
+	friend class ObjectPool<ZombieBlast>;
 	ZombieBlast(Sprite::ID spriteID, sf::Vector2f pos, sf::Vector2f clickPos, float speed = 1.f, int duration = 100, int damage = 1, float startingSize = 1.f, float growRate = 0.05f) : GraphicalGameObject(SpriteFactory::generateSprite(spriteID))
 	{
+		this->reset(spriteID, pos, clickPos, speed, duration, damage, startingSize, growRate);
+	}
+
+	void reset(Sprite::ID spriteID, sf::Vector2f pos, sf::Vector2f clickPos, float speed = 1.f, int duration = 100, int damage = 1, float startingSize = 1.f, float growRate = 0.05f)
+	{
+		*this->getSprite() = SpriteFactory::generateSprite(spriteID); //undoes the transform and color of a recycled blast
 		const double pi = 3.14159265358979323846;
 		double radians = atan2(D(clickPos.y - pos.y), D(clickPos.x - pos.x));
 		this->distance = sf::Vector2f(F(cos(radians)) * speed, F(sin(radians)) * speed);
-		sf::Vector2u size = this->spritePtr()->getTexture()->getSize();
-		this->spritePtr()->setOrigin(static_cast<float>(size.x) / 2.f, static_cast<float>(size.y) / 2.f);
-		this->spritePtr()->setRotation(F(radians * (180.0 / pi) - 180.0));
-		this->spritePtr()->setPosition(pos.x + (this->distance.x * 5.f), pos.y + (this->distance.y * 5.f));
-		this->spritePtr()->setScale(startingSize, startingSize);
+		sf::IntRect size = this->getSprite()->getTextureRect();
+		this->getSprite()->setOrigin(static_cast<float>(size.width) / 2.f, static_cast<float>(size.height) / 2.f);
+		this->getSprite()->setRotation(F(radians * (180.0 / pi) - 180.0));
+		this->getSprite()->setPosition(pos.x + (this->distance.x * 5.f), pos.y + (this->distance.y * 5.f));
+		this->getSprite()->setScale(startingSize, startingSize);
 		this->blastLife = duration;
 		this->growRate = growRate;
+		this->growth = 1.f;
 		this->damage = damage;
 	}
 
+private:
+	static ObjectPool<ZombieBlast>& getPool()
+	{
+		static ObjectPool<ZombieBlast> pool;
+		return pool;
+	}
+public:
+	//blasts are recycled, a removed blast goes back to the pool for the next shot
+	static ZombieBlast* create(Sprite::ID spriteID, sf::Vector2f pos, sf::Vector2f clickPos, float speed = 1.f, int duration = 100, int damage = 1, float startingSize = 1.f, float growRate = 0.05f)
+	{
+		return getPool().acquire(spriteID, pos, clickPos, speed, duration, damage, startingSize, growRate);
+	}
+
+	virtual void RemovedFromScreen()
+	{
+		getPool().release(this);
+	}
+
 	virtual void EveryFrame(uint64_t f)
 	{
 		this->move(this->distance);
 		this->growth += growRate / 60.0f;
-		this->spritePtr()->setScale(this->growth, this->growth);
+		this->getSprite()->setScale(this->growth, this->growth);
 		this->blastLife--;
 		if (this->blastLife <= 0) { this->screen->remove(this); }
 	}
@@ -54,27 +81,46 @@ public:
 	{
 		return this->damage;
 	}
-
-	sf::Sprite* spritePtr()
-	{
-		return dynamic_cast<sf::Sprite*>(this->graphic);
-	}
 };
 
 class SuperZombieBlast : public ZombieBlast
 {
 private:
 	float rotationRate = -3.f;
-public:
+
+	friend class ObjectPool<SuperZombieBlast>;
 	SuperZombieBlast(Sprite::ID spriteID, sf::Vector2f pos, sf::Vector2f clickPos, float speed = 1.f, int duration = 100, int damage = 1, float startingSize = 1.f, float growRate = 0.05f)
 		: ZombieBlast(spriteID, pos, clickPos, speed, duration, damage, startingSize, growRate)
 	{
-		this->spritePtr()->setColor(sf::Color(255, 255, 255, 150));
+		this->getSprite()->setColor(sf::Color(255, 255, 255, 150));
+	}
+
+	void reset(Sprite::ID spriteID, sf::Vector2f pos, sf::Vector2f clickPos, float speed = 1.f, int duration = 100, int damage = 1, float startingSize = 1.f, float growRate = 0.05f)
+	{
+		ZombieBlast::reset(spriteID, pos, clickPos, speed, duration, damage, startingSize, growRate);
+		this->getSprite()->setColor(sf::Color(255, 255, 255, 150));
+		this->rotationRate = -3.f;
+	}
+
+	static ObjectPool<SuperZombieBlast>& getPool()
+	{
+		static ObjectPool<SuperZombieBlast> pool;
+		return pool;
+	}
+public:
+	static SuperZombieBlast* create(Sprite::ID spriteID, sf::Vector2f pos, sf::Vector2f clickPos, float speed = 1.f, int duration = 100, int damage = 1, float startingSize = 1.f, float growRate = 0.05f)
+	{
+		return getPool().acquire(spriteID, pos, clickPos, speed, duration, damage, startingSize, growRate);
+	}
+
+	void RemovedFromScreen()
+	{
+		getPool().release(this);
 	}
 
 	void EveryFrame(uint64_t f)
 	{
-		sf::Sprite* spr = this->spritePtr();
+		sf::Sprite* spr = this->getSprite();
 		this->move(this->distance);
 		this->growth += growRate / 60.f;
 		spr->setScale(this->growth, this->growth);
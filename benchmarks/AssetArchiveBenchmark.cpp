@@ -0,0 +1,202 @@
+//compares loading every asset from the loose files in data/ against loading them from the packed archive built by tools/AssetPacker
+//each pass first reads the raw bytes of every file, then decodes the images, sounds, music and fonts the way ResourceManager does
+//archive passes include mounting and unmounting the archive, so both sides pay for everything a cold start does
+//--drop-caches empties the page cache before every pass so the reads come from disk, it needs root on Linux and is ignored elsewhere
+//it is built with MappedFile.cpp, links against SFML only and is run from the repository root after building the archive
+//usage: AssetArchiveBenchmark [--archive data/assets.pak] [--runs N] [--drop-caches] [--label TEXT] > results.json
+
+#include "../AssetArchive.h"
+#include "SFML/Audio.hpp"
+#include "SFML/Graphics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace Engine;
+
+namespace
+{
+	struct Pass
+	{
+		double readMicroseconds = 0;
+		double decodeMicroseconds = 0;
+		uint64_t bytes = 0;
+		int failures = 0;
+	};
+
+	bool dropCaches()
+	{
+		#ifdef _WIN32
+		return false;
+		#else
+		sync();
+		std::ofstream fout("/proc/sys/vm/drop_caches");
+		fout << "3" << std::endl;
+		return static_cast<bool>(fout);
+		#endif
+	}
+
+	bool endsWith(const std::string& name, const std::string& suffix)
+	{
+		return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+	}
+
+	//decodes one file with the SFML type the game loads it as, files the game does not decode count as read
+	bool decode(const std::string& name)
+	{
+		if (endsWith(name, ".png"))
+		{
+			sf::Image image;
+			return AssetArchive::loadResource(name, image);
+		}
+		if (endsWith(name, ".ttf"))
+		{
+			sf::Font font;
+			return AssetArchive::loadResource(name, font);
+		}
+		if (endsWith(name, ".ogg") && name.compare(0, 6, "theme_") == 0)
+		{
+			//music streams, opening it only reads the header like MusicPlayer does before playing
+			sf::Music music;
+			const uint8_t* data;
+			size_t size;
+			if (AssetArchive::findMounted(name, data, size)) { return music.openFromMemory(data, size); }
+			return music.openFromFile(std::string("data/") + name);
+		}
+		if (endsWith(name, ".ogg") || endsWith(name, ".wav"))
+		{
+			sf::SoundBuffer buffer;
+			return AssetArchive::loadResource(name, buffer);
+		}
+		return true;
+	}
+
+	//reads every byte, one file open each for loose files, or touches every page of the archive
+	uint64_t readAll(const std::vector<std::string>& names, bool fromArchive)
+	{
+		uint64_t checksum = 0;
+		std::vector<char> buffer;
+		for (auto const & name : names)
+		{
+			if (fromArchive)
+			{
+				const uint8_t* data;
+				size_t size;
+				if (!AssetArchive::findMounted(name, data, size)) { continue; }
+				for (size_t offset = 0; offset < size; offset += 4096) { checksum += data[offset]; }
+				continue;
+			}
+			std::ifstream fin((std::string("data/") + name).c_str(), std::ios::binary | std::ios::ate);
+			std::streamoff size = fin ? static_cast<std::streamoff>(fin.tellg()) : 0;
+			buffer.resize(static_cast<size_t>((size > 0) ? size : 0));
+			fin.seekg(0);
+			fin.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			for (size_t offset = 0; offset < buffer.size(); offset += 4096) { checksum += static_cast<uint8_t>(buffer[offset]); }
+		}
+		return checksum;
+	}
+
+	Pass runPass(const std::vector<std::string>& names, const std::string& archivePath, bool fromArchive, bool drop, uint64_t& checksum)
+	{
+		using Clock = std::chrono::steady_clock;
+		Pass pass;
+
+		if (drop) { dropCaches(); }
+		auto start = Clock::now();
+		if (fromArchive) { AssetArchive::mount(archivePath); }
+		checksum += readAll(names, fromArchive);
+		if (fromArchive) { AssetArchive::unmount(); }
+		pass.readMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+		if (drop) { dropCaches(); }
+		start = Clock::now();
+		if (fromArchive) { AssetArchive::mount(archivePath); }
+		for (auto const & name : names)
+		{
+			if (!decode(name)) { pass.failures++; }
+		}
+		if (fromArchive) { AssetArchive::unmount(); }
+		pass.decodeMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+		for (auto const & name : names) { pass.bytes += AssetArchive::fileSize(name); }
+		return pass;
+	}
+
+	std::string toJson(const std::string& source, const std::vector<Pass>& passes)
+	{
+		Pass average;
+		for (auto const & pass : passes)
+		{
+			average.readMicroseconds += pass.readMicroseconds / static_cast<double>(passes.size());
+			average.decodeMicroseconds += pass.decodeMicroseconds / static_cast<double>(passes.size());
+			average.failures += pass.failures;
+		}
+		std::ostringstream json;
+		json << "\t\t{ \"source\": \"" << source << "\""
+			<< ", \"bytes\": " << passes.front().bytes
+			<< ", \"firstReadMicroseconds\": " << passes.front().readMicroseconds
+			<< ", \"firstDecodeMicroseconds\": " << passes.front().decodeMicroseconds
+			<< ", \"averageReadMicroseconds\": " << average.readMicroseconds
+			<< ", \"averageDecodeMicroseconds\": " << average.decodeMicroseconds
+			<< ", \"failures\": " << average.failures << " }";
+		return json.str();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string archivePath = "data/assets.pak";
+	std::string label;
+	int runs = 5;
+	bool drop = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--archive" && i + 1 < argc) { archivePath = argv[++i]; }
+		else if (arg == "--runs" && i + 1 < argc) { runs = std::max(1, std::atoi(argv[++i])); }
+		else if (arg == "--drop-caches") { drop = true; }
+		else if (arg == "--label" && i + 1 < argc) { label = argv[++i]; }
+	}
+
+	//the archive's index is the list of files, so both sides load exactly the same assets
+	if (!AssetArchive::mount(archivePath))
+	{
+		std::cerr << "could not mount " << archivePath << ", build it with tools/AssetPacker first" << std::endl;
+		return 1;
+	}
+	std::vector<std::string> names;
+	for (uint32_t i = 0; i < AssetArchive::getMountedArchive().size(); i++) { names.push_back(AssetArchive::getMountedArchive().name(i)); }
+	AssetArchive::unmount();
+	if (drop && !dropCaches())
+	{
+		std::cerr << "could not drop the page cache, every pass runs with a warm cache" << std::endl;
+		drop = false;
+	}
+
+	//the two sources take turns going first so neither always gets the other's warm cache
+	uint64_t checksum = 0;
+	std::vector<Pass> loose;
+	std::vector<Pass> archive;
+	for (int run = 0; run < runs; run++)
+	{
+		bool archiveFirst = (run % 2 == 1);
+		if (archiveFirst) { archive.push_back(runPass(names, archivePath, true, drop, checksum)); }
+		loose.push_back(runPass(names, archivePath, false, drop, checksum));
+		if (!archiveFirst) { archive.push_back(runPass(names, archivePath, true, drop, checksum)); }
+	}
+
+	std::cout << "{\n\t\"label\": \"" << label << "\",\n\t\"files\": " << names.size()
+		<< ",\n\t\"runs\": " << runs << ",\n\t\"coldCache\": " << (drop ? "true" : "false")
+		<< ",\n\t\"checksum\": " << checksum << ",\n\t\"sources\": [\n"
+		<< toJson("loose", loose) << ",\n" << toJson("archive", archive) << "\n\t]\n}" << std::endl;
+	return 0;
+}
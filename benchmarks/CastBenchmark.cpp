@@ -0,0 +1,100 @@
+//compares Screen's per frame passes resolving capabilities with dynamic_cast against the cached pointers it now keeps per entry
+//the hierarchy mirrors the engine's: attributes inherit virtually from a shared base and game objects inherit several attributes
+//usage: CastBenchmark [--passes N] > results.json
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct BenchSprite { virtual ~BenchSprite() {} float x = 0.f; float y = 0.f; };
+
+	class BenchObject { public: virtual ~BenchObject() {} };
+	class BenchDrawableAccess { public: virtual ~BenchDrawableAccess() {} };
+	class BenchCollision : public virtual BenchDrawableAccess { };
+	class BenchTerrainCollision : public virtual BenchDrawableAccess { public: float obstacleWidth = 1.f; };
+	class BenchMovement : public virtual BenchDrawableAccess { public: float xVelocity = 1.f; float yVelocity = 0.5f; };
+	class BenchGraphical : public BenchObject { public: BenchSprite* graphic = nullptr; };
+	class BenchWalker : public BenchGraphical, public BenchCollision, public BenchTerrainCollision, public BenchMovement { };
+	class BenchFlyer : public BenchGraphical, public BenchCollision, public BenchMovement { };
+
+	struct Entry
+	{
+		BenchMovement* movement;
+		BenchTerrainCollision* terrainCollision;
+		BenchSprite* sprite;
+	};
+
+	template<typename Func> double averageMicroseconds(int passes, Func func)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < passes; i++) { func(); }
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::micro>(elapsed).count() / static_cast<double>(passes);
+	}
+
+	std::string runSize(size_t count, int passes)
+	{
+		std::vector<BenchGraphical*> owned;
+		std::vector<BenchMovement*> moving;
+		std::vector<Entry> entries;
+		for (size_t i = 0; i < count; i++)
+		{
+			BenchGraphical* obj = (i % 4 == 0) ? static_cast<BenchGraphical*>(new BenchFlyer()) : static_cast<BenchGraphical*>(new BenchWalker());
+			obj->graphic = new BenchSprite();
+			owned.push_back(obj);
+			BenchMovement* movement = dynamic_cast<BenchMovement*>(obj);
+			moving.push_back(movement);
+			entries.push_back({ movement, dynamic_cast<BenchTerrainCollision*>(obj), obj->graphic });
+		}
+
+		//what the movement pass did before: recover the object, its sprite and its terrain capability every frame
+		double castTime = averageMicroseconds(passes, [&]()
+		{
+			for (BenchMovement* obj : moving)
+			{
+				BenchGraphical* ggo = dynamic_cast<BenchGraphical*>(obj);
+				BenchSprite* spr = dynamic_cast<BenchSprite*>(ggo->graphic);
+				float width = 0.f;
+				if (BenchTerrainCollision* terrain = dynamic_cast<BenchTerrainCollision*>(obj)) { width = terrain->obstacleWidth; }
+				spr->x += obj->xVelocity + width;
+				spr->y += obj->yVelocity;
+			}
+		});
+		double cachedTime = averageMicroseconds(passes, [&]()
+		{
+			for (Entry const & entry : entries)
+			{
+				float width = (entry.terrainCollision != nullptr) ? entry.terrainCollision->obstacleWidth : 0.f;
+				entry.sprite->x += entry.movement->xVelocity + width;
+				entry.sprite->y += entry.movement->yVelocity;
+			}
+		});
+
+		double checksum = 0.0;
+		for (BenchGraphical* obj : owned) { checksum += obj->graphic->x + obj->graphic->y; delete obj->graphic; delete obj; }
+
+		return "\t\t{ \"objects\": " + std::to_string(count)
+			+ ", \"dynamicCastMicrosecondsPerPass\": " + std::to_string(castTime)
+			+ ", \"cachedPointerMicrosecondsPerPass\": " + std::to_string(cachedTime)
+			+ ", \"checksum\": " + std::to_string(checksum) + " }";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int passes = 2000;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--passes" && i + 1 < argc) { passes = std::atoi(argv[++i]); }
+	}
+	std::cout << "{\n\t\"passes\": " << passes << ",\n\t\"results\": [\n"
+		<< runSize(1000, passes) << ",\n"
+		<< runSize(10000, passes) << "\n\t]\n}" << std::endl;
+	return 0;
+}
@@ -0,0 +1,97 @@
+//compares one per frame pass over Screen's old unordered_map storage against DenseObjectMap
+//both containers first go through insert/erase churn so the hash map's buckets are scattered like after a long session
+//usage: ContainerBenchmark [--passes N] > results.json
+
+#include "../DenseObjectMap.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	//stands in for a game object: a virtual call per visit, like EveryFrame
+	class BenchObject
+	{
+	public:
+		virtual ~BenchObject() {}
+		virtual void EveryFrame(uint64_t f) { this->counter += f; }
+		uint64_t counter = 0;
+	};
+
+	template<typename Func> double averageMicroseconds(int passes, Func func)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < passes; i++) { func(static_cast<uint64_t>(i)); }
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::micro>(elapsed).count() / static_cast<double>(passes);
+	}
+
+	std::string runSize(size_t count, int passes)
+	{
+		srand(1);
+		std::unordered_map<GameObjectID, BenchObject*> hashMap;
+		DenseObjectMap<BenchObject*> dense;
+		std::vector<BenchObject*> owned;
+		GameObjectID nextID = 1;
+		auto addObject = [&]()
+		{
+			BenchObject* obj = new BenchObject();
+			owned.push_back(obj);
+			hashMap[nextID] = obj;
+			dense.insert(nextID, obj);
+			nextID++;
+		};
+		for (size_t i = 0; i < count; i++) { addObject(); }
+
+		//replace half of the objects, the way blasts and citizens come and go during play
+		std::vector<GameObjectID> live;
+		for (auto const & pair : hashMap) { live.push_back(pair.first); }
+		for (size_t i = 0; i < count / 2; i++)
+		{
+			size_t index = static_cast<size_t>(rand()) % live.size();
+			GameObjectID id = live[index];
+			live[index] = live.back();
+			live.pop_back();
+			hashMap.erase(id);
+			dense.erase(id);
+			addObject();
+		}
+
+		double mapTime = averageMicroseconds(passes, [&](uint64_t f)
+		{
+			for (auto const & pair : hashMap) { pair.second->EveryFrame(f); }
+		});
+		double denseTime = averageMicroseconds(passes, [&](uint64_t f)
+		{
+			for (BenchObject* obj : dense) { obj->EveryFrame(f); }
+		});
+
+		uint64_t checksum = 0;
+		for (BenchObject* obj : owned) { checksum += obj->counter; delete obj; }
+
+		return "\t\t{ \"objects\": " + std::to_string(count)
+			+ ", \"unorderedMapMicrosecondsPerPass\": " + std::to_string(mapTime)
+			+ ", \"denseObjectMapMicrosecondsPerPass\": " + std::to_string(denseTime)
+			+ ", \"checksum\": " + std::to_string(checksum) + " }";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int passes = 2000;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--passes" && i + 1 < argc) { passes = std::atoi(argv[++i]); }
+	}
+	std::cout << "{\n\t\"passes\": " << passes << ",\n\t\"results\": [\n"
+		<< runSize(1000, passes) << ",\n"
+		<< runSize(10000, passes) << "\n\t]\n}" << std::endl;
+	return 0;
+}
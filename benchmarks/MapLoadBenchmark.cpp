@@ -0,0 +1,152 @@
+//compares loading a tile map from the text format, the way TileMap used to, against mapping the binary format
+//the map is also tiled 10x10 to show how each path scales to a map 100 times larger
+//usage: MapLoadBenchmark [--map data/map_normal.txt] [--runs N] > results.json
+
+#include "../BinaryMap.h"
+#include "../MappedFile.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	TileProperties properties;
+
+	template<typename Func> double averageMicroseconds(int runs, Func func)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < runs; i++) { func(); }
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::micro>(elapsed).count() / static_cast<double>(runs);
+	}
+
+	//the old TileMap::readFromFile plus its safe spawn scan
+	size_t loadTextWithStream(const std::string& filename)
+	{
+		std::ifstream fin(filename.c_str());
+		unsigned int width, height, tileWidth, tileHeight;
+		fin >> width >> height >> tileWidth >> tileHeight;
+		int* tiles = new int[width * height];
+		for (unsigned int i = 0; i < width * height; i++) { fin >> tiles[i]; }
+		auto tileAt = [&](unsigned int i, unsigned int j) { return (i < 1 || j < 1 || i >= width || j >= height) ? -1 : tiles[i + j * width]; };
+		size_t spawns = 0;
+		for (unsigned int i = 1; i + 1 < width; i++)
+		{
+			for (unsigned int j = 1; j + 1 < height; j++)
+			{
+				bool anyObstacles = false;
+				for (int di = -1; di <= 1; di++)
+				{
+					for (int dj = -1; dj <= 1; dj++) { if ((di != 0 || dj != 0) && (properties.flagsFor(tileAt(i + di, j + dj)) & TileProperties::Obstacle)) { anyObstacles = true; } }
+				}
+				if (!anyObstacles) { spawns++; }
+			}
+		}
+		delete[] tiles;
+		return spawns;
+	}
+
+	size_t loadTextWithEncoder(const std::string& filename)
+	{
+		MappedFile file;
+		file.open(filename);
+		std::vector<uint8_t> image = BinaryMap::encodeText(reinterpret_cast<const char*>(file.data()), file.size(), properties);
+		BinaryMap map;
+		map.view(image.data(), image.size());
+		return map.spawnCount();
+	}
+
+	size_t loadBinary(const std::string& filename)
+	{
+		MappedFile file;
+		file.open(filename);
+		BinaryMap map;
+		map.view(file.data(), file.size());
+		std::vector<std::pair<float, float>> spawns(map.spawnCount());
+		for (uint32_t i = 0; i < map.spawnCount(); i++) { map.getSpawn(i, spawns[i].first, spawns[i].second); }
+		return spawns.size();
+	}
+
+	//writes a text map made of the source map repeated factor times in each direction
+	bool writeTiledTextMap(const std::string& source, const std::string& destination, int factor)
+	{
+		std::ifstream fin(source.c_str());
+		unsigned int width, height, tileWidth, tileHeight;
+		if (!(fin >> width >> height >> tileWidth >> tileHeight)) { return false; }
+		std::vector<int> tiles(width * height);
+		for (int& tile : tiles) { fin >> tile; }
+		std::ofstream fout(destination.c_str());
+		fout << width * factor << "\n" << height * factor << "\n" << tileWidth << "\n" << tileHeight << "\n";
+		for (unsigned int j = 0; j < height * factor; j++)
+		{
+			for (unsigned int i = 0; i < width * factor; i++) { fout << tiles[(i % width) + (j % height) * width] << " "; }
+			fout << "\n";
+		}
+		return static_cast<bool>(fout);
+	}
+
+	bool writeBinaryMap(const std::string& source, const std::string& destination)
+	{
+		MappedFile file;
+		if (!file.open(source)) { return false; }
+		std::vector<uint8_t> image = BinaryMap::encodeText(reinterpret_cast<const char*>(file.data()), file.size(), properties);
+		std::ofstream fout(destination.c_str(), std::ios::binary);
+		fout.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+		return !image.empty() && static_cast<bool>(fout);
+	}
+
+	std::string runMap(const std::string& name, const std::string& textFile, int runs)
+	{
+		std::string binaryFile = textFile + ".bmap";
+		if (!writeBinaryMap(textFile, binaryFile)) { return ""; }
+		size_t checksum = 0;
+		double streamTime = averageMicroseconds(runs, [&]() { checksum += loadTextWithStream(textFile); });
+		double encodeTime = averageMicroseconds(runs, [&]() { checksum += loadTextWithEncoder(textFile); });
+		double binaryTime = averageMicroseconds(runs, [&]() { checksum += loadBinary(binaryFile); });
+		std::remove(binaryFile.c_str());
+
+		std::ostringstream json;
+		json << "\t\t{ \"map\": \"" << name << "\""
+			<< ", \"textStreamMicroseconds\": " << streamTime
+			<< ", \"textEncodeMicroseconds\": " << encodeTime
+			<< ", \"binaryMappedMicroseconds\": " << binaryTime
+			<< ", \"checksum\": " << checksum << " }";
+		return json.str();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string mapFile = "data/map_normal.txt";
+	int runs = 200;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--map" && i + 1 < argc) { mapFile = argv[++i]; }
+		else if (arg == "--runs" && i + 1 < argc) { runs = std::atoi(argv[++i]); }
+	}
+
+	if (!properties.loadFromFile("data/tile_properties.txt"))
+	{
+		std::cerr << "could not read data/tile_properties.txt" << std::endl;
+		return 1;
+	}
+	std::string largeFile = "map_benchmark_large.txt";
+	if (!writeTiledTextMap(mapFile, largeFile, 10))
+	{
+		std::cerr << "could not read " << mapFile << std::endl;
+		return 1;
+	}
+	std::string small = runMap(mapFile, mapFile, runs);
+	std::string large = runMap("10x10 tiled " + mapFile, largeFile, (runs / 10 > 0) ? runs / 10 : 1);
+	std::remove(largeFile.c_str());
+	std::cout << "{\n\t\"runs\": " << runs << ",\n\t\"results\": [\n" << small << ",\n" << large << "\n\t]\n}" << std::endl;
+	return 0;
+}
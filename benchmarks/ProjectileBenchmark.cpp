@@ -0,0 +1,126 @@
+//fires thousands of mage and zombie blasts per second across an empty level and counts heap allocations per frame
+//blasts come from their object pools, so once the pools and Screen's containers have grown the steady state should allocate nothing
+//build it with every engine .cpp file except main.cpp and run it from the repository root so data/ resolves
+//usage: ProjectileBenchmark [--frames N] [--label TEXT] > results.json
+
+#include "../MageBlast.h"
+#include "../ZombieBlast.h"
+#include "../Screen.h"
+#include "../TileMap.h"
+#include "../DifficultySettings.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+static std::atomic<uint64_t> heapAllocations(0);
+
+void* operator new(size_t size)
+{
+	heapAllocations++;
+	if (void* ptr = std::malloc((size > 0) ? size : 1)) { return ptr; }
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	heapAllocations++;
+	if (void* ptr = std::malloc((size > 0) ? size : 1)) { return ptr; }
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+	//fires an even mix of mage and zombie blasts between random points on the map every frame
+	class BlastStorm : public GameObject
+	{
+	private:
+		int perFrame;
+	public:
+		BlastStorm(int perFrame) : perFrame(perFrame) { }
+
+		void EveryFrame(uint64_t f)
+		{
+			const TileMap* map = this->screen->getMap();
+			int mapWidth = static_cast<int>(map->width() * map->tileSize().x);
+			int mapHeight = static_cast<int>(map->height() * map->tileSize().y);
+			for (int i = 0; i < this->perFrame; i++)
+			{
+				sf::Vector2f from(static_cast<float>(rand() % mapWidth), static_cast<float>(rand() % mapHeight));
+				sf::Vector2f to(static_cast<float>(rand() % mapWidth), static_cast<float>(rand() % mapHeight));
+				if (i % 2 == 0) { this->screen->add(MageBlast::create(from, to, 1.5, 135)); }
+				else { this->screen->add(ZombieBlast::create(Sprite::ID::Blast, from, to, 3.5f, 140)); }
+			}
+		}
+	};
+
+	std::string runStorm(int perFrame, uint64_t frames)
+	{
+		//blasts live at most 140 frames, after that every new shot can reuse one that expired
+		const uint64_t warmupFrames = 300;
+		srand(1);
+		DifficultySettings::setDifficulty(DifficultySettings::DIFFICULTY::TEST);
+
+		Screen* screen = new Screen();
+		TileMap* map = new TileMap();
+		map->load(DifficultySettings::Map::picture, DifficultySettings::Map::fileName);
+		screen->addMap(map);
+		screen->add(new BlastStorm(perFrame));
+
+		uint64_t before = heapAllocations;
+		screen->runHeadless(warmupFrames);
+		uint64_t warmupAllocations = heapAllocations - before;
+
+		Screen::resetPhaseTimings();
+		sf::Clock wallClock;
+		before = heapAllocations;
+		uint64_t simulated = screen->runHeadless(frames);
+		uint64_t steadyAllocations = heapAllocations - before;
+		sf::Int64 wall = wallClock.getElapsedTime().asMicroseconds();
+
+		delete screen;
+		delete map;
+
+		double steps = static_cast<double>((simulated > 0) ? simulated : 1);
+		std::ostringstream json;
+		json << "\t\t{\n"
+			<< "\t\t\t\"blastsPerFrame\": " << perFrame << ",\n"
+			<< "\t\t\t\"blastsPerSecond\": " << perFrame * static_cast<int>(TimeUnit::ticksPerSecond) << ",\n"
+			<< "\t\t\t\"frames\": " << simulated << ",\n"
+			<< "\t\t\t\"wallMicrosecondsPerFrame\": " << static_cast<double>(wall) / steps << ",\n"
+			<< "\t\t\t\"warmupAllocationsPerFrame\": " << static_cast<double>(warmupAllocations) / static_cast<double>(warmupFrames) << ",\n"
+			<< "\t\t\t\"steadyAllocationsPerFrame\": " << static_cast<double>(steadyAllocations) / steps << "\n"
+			<< "\t\t}";
+		return json.str();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint64_t frames = 600;
+	std::string label;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--frames" && i + 1 < argc) { frames = std::strtoull(argv[++i], nullptr, 10); }
+		else if (arg == "--label" && i + 1 < argc) { label = argv[++i]; }
+	}
+
+	std::vector<std::string> results;
+	for (int perFrame : { 10, 50, 100 }) { results.push_back(runStorm(perFrame, frames)); }
+
+	std::cout << "{\n\t\"label\": \"" << label << "\",\n\t\"storms\": [\n";
+	for (size_t i = 0; i < results.size(); i++) { std::cout << results[i] << ((i + 1 < results.size()) ? ",\n" : "\n"); }
+	std::cout << "\t]\n}" << std::endl;
+	return 0;
+}
@@ -0,0 +1,209 @@
+//runs TestLevel style scenes headlessly at scaled entity counts and prints per phase timings as json
+//build it with every engine .cpp file except main.cpp and run it from the repository root so data/ resolves
+//usage: SceneBenchmark [--frames N] [--max-entities N] [--draw] [--label TEXT] > results.json
+
+#include "../MainCharacter.h"
+#include "../Screen.h"
+#include "../TileMap.h"
+#include "../RespawnManager.h"
+#include "../DifficultySettings.h"
+#include "../Score.h"
+#include "../SpriteFactory.h"
+#include "../InputSource.h"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	struct Scenario
+	{
+		std::string name;
+		int citizens;
+		int mages;
+		int projectilesPerFrame;
+	};
+
+	//fires a mix of mage and zombie blasts between random points on the map every frame
+	class ProjectileStorm : public GameObject
+	{
+	private:
+		int perFrame;
+	public:
+		ProjectileStorm(int perFrame) : perFrame(perFrame) { }
+
+		void EveryFrame(uint64_t f)
+		{
+			const TileMap* map = this->screen->getMap();
+			int mapWidth = static_cast<int>(map->width() * map->tileSize().x);
+			int mapHeight = static_cast<int>(map->height() * map->tileSize().y);
+			for (int i = 0; i < this->perFrame; i++)
+			{
+				sf::Vector2f from(static_cast<float>(rand() % mapWidth), static_cast<float>(rand() % mapHeight));
+				sf::Vector2f to(static_cast<float>(rand() % mapWidth), static_cast<float>(rand() % mapHeight));
+				if (i % 2 == 0) { this->screen->add(MageBlast::create(from, to, 1.5, 135)); }
+				else { this->screen->add(ZombieBlast::create(Sprite::ID::Blast, from, to, 3.5f, 140)); }
+			}
+		}
+	};
+
+	//what a player's hardware sends without changing the scene, a burst of mouse moves every step like a high polling rate mouse
+	//and a tap of a key nothing binds every few steps, so both the coalescing and the key subscribers are measured
+	class PlayerInput : public InputSource
+	{
+	public:
+		void poll(uint64_t step, std::vector<sf::Event>& events)
+		{
+			sf::Event ev;
+			ev.type = sf::Event::MouseMoved;
+			for (int i = 0; i < movesPerStep; i++)
+			{
+				ev.mouseMove = { static_cast<int>(step % 1024), i };
+				events.push_back(ev);
+			}
+			if (step % 10 != 0) { return; }
+			ev.type = sf::Event::KeyPressed;
+			ev.key = { sf::Keyboard::Q, false, false, false, false };
+			events.push_back(ev);
+			ev.type = sf::Event::KeyReleased;
+			events.push_back(ev);
+		}
+
+		static constexpr int movesPerStep = 4;
+	};
+
+	std::string runScenario(const Scenario& scenario, uint64_t frames, sf::RenderWindow* drawTarget)
+	{
+		const uint64_t warmupFrames = 60;
+		srand(1);
+		DifficultySettings::setDifficulty(DifficultySettings::DIFFICULTY::TEST);
+		numMagesAlive = 0;
+
+		Screen* screen = new Screen();
+		TileMap* map = new TileMap();
+		map->load(DifficultySettings::Map::picture, DifficultySettings::Map::fileName);
+		screen->addMap(map);
+
+		MainCharacter* mc = new MainCharacter("benchmark");
+		mc->getDrawablePtr()->setPosition(static_cast<float>(map->width() * map->tileSize().x / 2), static_cast<float>(map->height() * map->tileSize().y / 2));
+		screen->addMainCharacter(mc);
+
+		sf::Text scoreText;
+		Score* score = new Score(scoreText);
+		scorePtr = score;
+		screen->addUIObject(score);
+
+		//split the citizen cap across the same sprite types TestLevel uses
+		const Sprite::ID citizenSprites[] = { Sprite::ID::Boy, Sprite::ID::Girl, Sprite::ID::Man, Sprite::ID::Woman, Sprite::ID::Oldman, Sprite::ID::Oldwoman };
+		const int numCitizenSprites = static_cast<int>(sizeof(citizenSprites) / sizeof(citizenSprites[0]));
+		for (int i = 0; i < numCitizenSprites; i++)
+		{
+			int cap = scenario.citizens / numCitizenSprites + ((i < scenario.citizens % numCitizenSprites) ? 1 : 0);
+			if (cap == 0) { continue; }
+			RespawnManager<Citizen>* citizenMng = new RespawnManager<Citizen>(citizenSprites[i], cap, 200);
+			screen->add(citizenMng);
+			citizenMng->fill();
+		}
+		if (scenario.mages > 0)
+		{
+			RespawnManager<Mage>* mageMng = new RespawnManager<Mage>(Sprite::ID::Mage, scenario.mages, 175);
+			screen->add(mageMng);
+			mageMng->fill();
+		}
+		if (scenario.projectilesPerFrame > 0) { screen->add(new ProjectileStorm(scenario.projectilesPerFrame)); }
+
+		PlayerInput input;
+		screen->runHeadless(warmupFrames, &input, drawTarget);
+		Screen::resetPhaseTimings();
+		sf::Clock wallClock;
+		uint64_t simulated = screen->runHeadless(frames, &input, drawTarget);
+		sf::Int64 wall = wallClock.getElapsedTime().asMicroseconds();
+		Screen::PhaseTimings timings = Screen::getPhaseTimings();
+
+		delete screen;
+		delete map;
+
+		double steps = static_cast<double>((simulated > 0) ? simulated : 1);
+		double drawnFrames = static_cast<double>((timings.renderedFrames > 0) ? timings.renderedFrames : 1);
+		auto perFrame = [&](sf::Int64 total) { return static_cast<double>(total) / steps; };
+		std::ostringstream json;
+		json << "\t\t{\n"
+			<< "\t\t\t\"name\": \"" << scenario.name << "\",\n"
+			<< "\t\t\t\"citizens\": " << scenario.citizens << ",\n"
+			<< "\t\t\t\"mages\": " << scenario.mages << ",\n"
+			<< "\t\t\t\"projectilesPerFrame\": " << scenario.projectilesPerFrame << ",\n"
+			<< "\t\t\t\"frames\": " << simulated << ",\n"
+			<< "\t\t\t\"wallMicrosecondsPerFrame\": " << perFrame(wall) << ",\n"
+			<< "\t\t\t\"microsecondsPerFrame\": {\n"
+			<< "\t\t\t\t\"events\": " << perFrame(timings.events) << ",\n"
+			<< "\t\t\t\t\"movement\": " << perFrame(timings.movement) << ",\n"
+			<< "\t\t\t\t\"collision\": " << perFrame(timings.collision) << ",\n"
+			<< "\t\t\t\t\"draw\": " << perFrame(timings.draw) << ",\n"
+			<< "\t\t\t\t\"removal\": " << perFrame(timings.removal) << "\n"
+			<< "\t\t\t},\n"
+			<< "\t\t\t\"collisionPairsTestedPerFrame\": " << static_cast<double>(timings.collisionPairsTested) / steps << ",\n"
+			<< "\t\t\t\"collisionPairsHitPerFrame\": " << static_cast<double>(timings.collisionPairsHit) / steps << ",\n"
+			<< "\t\t\t\"flowFieldRebuilds\": " << timings.flowFieldRebuilds << ",\n"
+			<< "\t\t\t\"eventsDispatchedPerFrame\": " << static_cast<double>(timings.eventsDispatched) / steps << ",\n"
+			<< "\t\t\t\"mouseMovesCoalescedPerFrame\": " << static_cast<double>(timings.mouseMovesCoalesced) / steps << ",\n"
+			<< "\t\t\t\"spritesBatchedPerFrame\": " << static_cast<double>(timings.spritesBatched) / drawnFrames << ",\n"
+			<< "\t\t\t\"spriteBatchDrawCallsPerFrame\": " << static_cast<double>(timings.spriteBatchDrawCalls) / drawnFrames << ",\n"
+			<< "\t\t\t\"objectsDrawnPerFrame\": " << static_cast<double>(timings.objectsDrawn) / drawnFrames << ",\n"
+			<< "\t\t\t\"objectsCulledPerFrame\": " << static_cast<double>(timings.objectsCulled) / drawnFrames << "\n"
+			<< "\t\t}";
+		return json.str();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint64_t frames = 600;
+	int maxEntities = 10000;
+	bool draw = false;
+	std::string label;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--frames" && i + 1 < argc) { frames = std::strtoull(argv[++i], nullptr, 10); }
+		else if (arg == "--max-entities" && i + 1 < argc) { maxEntities = std::atoi(argv[++i]); }
+		else if (arg == "--draw") { draw = true; }
+		else if (arg == "--label" && i + 1 < argc) { label = argv[++i]; }
+	}
+
+	Screen::windowWidth = 1024;
+	Screen::windowHeight = 768;
+	Screen::windowTitle = "Cursed Zombie Benchmark";
+
+	std::vector<Scenario> scenarios;
+	for (int entities : { 10, 100, 1000, 10000 })
+	{
+		if (entities > maxEntities) { continue; }
+		scenarios.push_back({ "entities_" + std::to_string(entities), entities, entities, 0 });
+	}
+	for (int projectiles : { 10, 50 })
+	{
+		scenarios.push_back({ "storm_" + std::to_string(projectiles), 20, 12, projectiles });
+	}
+
+	//drawing needs a real render target, a hidden window keeps the run off screen
+	sf::RenderWindow* drawTarget = nullptr;
+	if (draw)
+	{
+		drawTarget = new sf::RenderWindow(sf::VideoMode(Screen::windowWidth, Screen::windowHeight), Screen::windowTitle, sf::Style::None);
+		drawTarget->setVisible(false);
+	}
+
+	std::cout << "{\n\t\"label\": \"" << label << "\",\n\t\"draw\": " << (draw ? "true" : "false") << ",\n\t\"scenarios\": [\n";
+	for (size_t i = 0; i < scenarios.size(); i++)
+	{
+		std::cout << runScenario(scenarios[i], frames, drawTarget) << ((i + 1 < scenarios.size()) ? ",\n" : "\n");
+	}
+	std::cout << "\t]\n}" << std::endl;
+
+	delete drawTarget;
+	return 0;
+}
@@ -1,6 +1,7 @@
 #include "Screen.h"
 #include "Menu.h"
 #include "DebugManager.h"
+#include "AssetArchive.h"
 #include <string>
 
 #ifdef _MSC_VER
@@ -32,6 +33,14 @@ int main(int argc, char** argv)
 	Screen::windowWidth = 1024;
 	Screen::windowHeight = 768;
 	Screen::windowTitle = "Cursed Zombie";
+	Screen::frameRate = 60;
+	Screen::framePacingMode = FramePacer::Mode::HybridSleep;
+
+	// with an archive built by tools/AssetPacker every asset is read from one memory mapped file, otherwise from the loose files in data/
+	if (AssetArchive::mount("data/assets.pak")) { DebugManager::PrintMessage(DebugManager::MessageType::RESOURCE_REPORTING, "Assets mounted from data/assets.pak."); }
+
+	// sound buffers past this many bytes are evicted, least recently played first, once no sound is playing them
+	ResourceManager<sf::SoundBuffer>::SetMemoryBudget(32 * 1024 * 1024);
 
 	Menu* menu = new Menu(true);
 	menu->start();
@@ -0,0 +1,115 @@
+//checks that ResourceManager keeps pointers, handles and requests valid across reloads, unloads and evictions, using the fonts in data/
+//build it with MappedFile.cpp and link against SFML like AssetArchiveBenchmark, and run it from the repository root so data/ resolves
+//usage: ResourceCacheTest, prints each failed case and exits with 1 if any failed
+
+#include "../ResourceManager.h"
+#include <iostream>
+#include <string>
+
+using namespace Engine;
+
+namespace
+{
+	int failures = 0;
+	int checks = 0;
+
+	void expect(const std::string& name, bool passed)
+	{
+		checks++;
+		if (passed) { return; }
+		failures++;
+		std::cout << "FAILED " << name << std::endl;
+	}
+
+	typedef ResourceManager<sf::Font> Fonts;
+
+	//a font that was deleted under its pointer would not get this far
+	bool usable(const sf::Font* font)
+	{
+		return font != nullptr && !font->getInfo().family.empty();
+	}
+}
+
+int main()
+{
+	//a handle held across a reload sees the reloaded font, and so does every pointer from GetResource
+	{
+		ResourceHandle<sf::Font> handle = Fonts::AcquireResource("arial.ttf");
+		sf::Font* pinned = Fonts::GetResource("arial.ttf");
+		size_t used = Fonts::GetMemoryUsed();
+		sf::Font* reloaded = Fonts::ReloadResource("arial.ttf");
+		expect("reload keeps the pointer", reloaded == pinned);
+		expect("reload keeps the handle", handle.get() == pinned);
+		expect("reloaded font is usable through the handle", usable(handle.get()));
+		expect("reload counts the font once", Fonts::GetMemoryUsed() == used);
+		handle = ResourceHandle<sf::Font>();
+		expect("reloaded font outlives the handle", Fonts::GetMemoryUsed() == used && usable(pinned));
+	}
+
+	//an unload waiting on a handle is cancelled when GetResource pins the font again
+	{
+		size_t before = Fonts::GetMemoryUsed();
+		ResourceHandle<sf::Font> handle = Fonts::AcquireResource("sansation.ttf");
+		size_t loaded = Fonts::GetMemoryUsed();
+		Fonts::UnloadResource("sansation.ttf");
+		expect("unload waits for the handle", Fonts::GetMemoryUsed() == loaded);
+		sf::Font* pinned = Fonts::GetResource("sansation.ttf");
+		expect("pinning returns the cached font", pinned == handle.get());
+		handle = ResourceHandle<sf::Font>();
+		expect("pinned font survives the last handle", Fonts::GetMemoryUsed() == loaded && loaded > before && usable(pinned));
+	}
+
+	//without a pin the unload still happens once the last handle goes
+	{
+		size_t before = Fonts::GetMemoryUsed();
+		ResourceHandle<sf::Font> handle = Fonts::AcquireResource("zombie.ttf");
+		Fonts::UnloadResource("zombie.ttf");
+		expect("unload waits for the handle", usable(handle.get()));
+		handle = ResourceHandle<sf::Font>();
+		expect("unload happens when the last handle goes", Fonts::GetMemoryUsed() == before);
+	}
+
+	//reloading a font that is not cached loads it, reloading everything keeps every pointer
+	{
+		sf::Font* loaded = Fonts::ReloadResource("harting.ttf");
+		expect("reload of an uncached font loads it", usable(loaded));
+		sf::Font* arial = Fonts::GetResource("arial.ttf");
+		ResourceHandle<sf::Font> handle = Fonts::AcquireResource("harting.ttf");
+		Fonts::ReloadAllResources();
+		expect("reload all keeps pointers", Fonts::GetResource("arial.ttf") == arial && usable(arial));
+		expect("reload all keeps handles", handle.get() == loaded && usable(handle.get()));
+	}
+
+	//a reload keeps a font unpinned, so it is evicted once nothing uses it
+	{
+		size_t before = Fonts::GetMemoryUsed();
+		ResourceHandle<sf::Font> handle = Fonts::AcquireResource("zombie.ttf");
+		Fonts::ReloadResource("zombie.ttf");
+		handle = ResourceHandle<sf::Font>();
+		Fonts::SetMemoryBudget(1);
+		expect("reloaded font is still evictable", Fonts::GetMemoryUsed() == before);
+		Fonts::SetMemoryBudget(0);
+	}
+
+	//a request keeps its font cached while a copy of it exists, whether the font was cached already or loaded for it
+	{
+		size_t before = Fonts::GetMemoryUsed();
+		ResourceHandle<sf::Font> handle = Fonts::AcquireResource("zombie.ttf");
+		ResourceRequest<sf::Font> cached = Fonts::RequestResource("zombie.ttf");
+		handle = ResourceHandle<sf::Font>();
+		ResourceRequest<sf::Font> loaded = Fonts::RequestResource("Lycanthrope.ttf");
+		expect("background load is usable", usable(loaded.get()));
+		size_t requested = Fonts::GetMemoryUsed();
+		Fonts::SetMemoryBudget(1);
+		expect("requests keep their fonts cached", Fonts::GetMemoryUsed() == requested && requested > before);
+		expect("requests still return their fonts", usable(cached.get()) && usable(loaded.get()));
+		cached = ResourceRequest<sf::Font>();
+		loaded = ResourceRequest<sf::Font>();
+		Fonts::SetMemoryBudget(1);
+		expect("fonts are evicted once their requests are gone", Fonts::GetMemoryUsed() == before);
+		Fonts::SetMemoryBudget(0);
+	}
+
+	std::cout << (checks - failures) << " of " << checks << " resource cache checks passed" << std::endl;
+	return (failures == 0) ? 0 : 1;
+}
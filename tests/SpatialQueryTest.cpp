@@ -0,0 +1,184 @@
+//checks Screen::queryRect, queryRadius and nearest against a brute force scan of the same objects
+//build it with every engine .cpp file except main.cpp and link against SFML like SceneBenchmark, it needs no data files
+//usage: SpatialQueryTest, prints each failed case and exits with 1 if any failed
+
+#include "../Screen.h"
+#include "../GameObjectAttribute.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	int failures = 0;
+	int checks = 0;
+
+	void expect(const std::string& name, bool passed)
+	{
+		checks++;
+		if (passed) { return; }
+		failures++;
+		std::cout << "FAILED " << name << std::endl;
+	}
+
+	//a plain box, the sprite has no texture so its bounds come from the texture rect alone
+	class Crate : public GraphicalGameObject, public Collision
+	{
+	public:
+		Crate(sf::Vector2f position, sf::Vector2i size) : GraphicalGameObject(sf::Sprite())
+		{
+			this->getSprite()->setTextureRect(sf::IntRect(0, 0, size.x, size.y));
+			this->getSprite()->setPosition(position);
+		}
+
+		sf::FloatRect bounds()
+		{
+			return this->getSprite()->getGlobalBounds();
+		}
+	};
+
+	class Raider : public Crate, public Enemy
+	{
+	public:
+		Raider(sf::Vector2f position, sf::Vector2i size) : Crate(position, size) { }
+	};
+
+	float distanceSquared(sf::Vector2f point, const sf::FloatRect& box)
+	{
+		float dx = std::max(std::max(box.left - point.x, 0.f), point.x - (box.left + box.width));
+		float dy = std::max(std::max(box.top - point.y, 0.f), point.y - (box.top + box.height));
+		return dx * dx + dy * dy;
+	}
+
+	template<typename T> std::vector<T*> sorted(std::vector<T*> objects)
+	{
+		std::sort(objects.begin(), objects.end());
+		return objects;
+	}
+
+	template<typename T> std::vector<T*> bruteRect(const std::vector<T*>& objects, sf::FloatRect rect)
+	{
+		std::vector<T*> found;
+		for (T* object : objects)
+		{
+			if (object->bounds().intersects(rect)) { found.push_back(object); }
+		}
+		return sorted(found);
+	}
+
+	template<typename T> std::vector<T*> bruteRadius(const std::vector<T*>& objects, sf::Vector2f center, float radius)
+	{
+		std::vector<T*> found;
+		for (T* object : objects)
+		{
+			if (distanceSquared(center, object->bounds()) <= radius * radius) { found.push_back(object); }
+		}
+		return sorted(found);
+	}
+
+	//the distance to the nearest object, ties make the object itself ambiguous so the distances are compared
+	template<typename T> float bruteNearest(const std::vector<T*>& objects, sf::Vector2f point, const GameObject* exclude)
+	{
+		float best = std::numeric_limits<float>::infinity();
+		for (T* object : objects)
+		{
+			if (object != exclude) { best = std::min(best, distanceSquared(point, object->bounds())); }
+		}
+		return best;
+	}
+
+	float randomIn(int range)
+	{
+		return static_cast<float>(rand() % range);
+	}
+}
+
+int main()
+{
+	srand(3);
+	Screen screen;
+	std::vector<Crate*> crates;
+	std::vector<Raider*> raiders;
+	for (int i = 0; i < 300; i++)
+	{
+		sf::Vector2f position(randomIn(2000) - 200.f, randomIn(2000) - 200.f);
+		sf::Vector2i size(8 + rand() % 120, 8 + rand() % 120);
+		if (i % 3 == 0)
+		{
+			Raider* raider = new Raider(position, size);
+			raiders.push_back(raider);
+			crates.push_back(raider);
+			screen.add(raider);
+		}
+		else
+		{
+			Crate* crate = new Crate(position, size);
+			crates.push_back(crate);
+			screen.add(crate);
+		}
+	}
+	//the grid is built by the collision pass, one step indexes every object
+	screen.runHeadless(1);
+
+	//removed objects stay in the grid until the next collision pass and must not be returned
+	for (size_t i = 0; i < crates.size(); i += 7)
+	{
+		screen.remove(crates[i]);
+		crates[i] = nullptr;
+	}
+	crates.erase(std::remove(crates.begin(), crates.end(), nullptr), crates.end());
+	std::vector<Raider*> liveRaiders;
+	for (Crate* crate : crates)
+	{
+		if (Raider* raider = dynamic_cast<Raider*>(crate)) { liveRaiders.push_back(raider); }
+	}
+	raiders = liveRaiders;
+
+	std::vector<Crate*> foundCrates;
+	std::vector<Raider*> foundRaiders;
+	for (int i = 0; i < 200; i++)
+	{
+		sf::Vector2f point(randomIn(2400) - 400.f, randomIn(2400) - 400.f);
+		sf::FloatRect rect(point.x, point.y, randomIn(400), randomIn(400));
+		float radius = randomIn(300);
+		std::string at = " at " + std::to_string(i);
+
+		screen.queryRect<Crate>(rect, foundCrates);
+		expect("queryRect" + at, sorted(foundCrates) == bruteRect(crates, rect));
+		screen.queryRect<Raider>(rect, foundRaiders);
+		expect("queryRect filtered to enemies" + at, sorted(foundRaiders) == bruteRect(raiders, rect));
+
+		screen.queryRadius<Crate>(point, radius, foundCrates);
+		expect("queryRadius" + at, sorted(foundCrates) == bruteRadius(crates, point, radius));
+		screen.queryRadius<Raider>(point, radius, foundRaiders);
+		expect("queryRadius filtered to enemies" + at, sorted(foundRaiders) == bruteRadius(raiders, point, radius));
+
+		Crate* nearestCrate = screen.nearest<Crate>(point);
+		expect("nearest" + at, nearestCrate != nullptr && distanceSquared(point, nearestCrate->bounds()) == bruteNearest(crates, point, nullptr));
+		Raider* nearestRaider = screen.nearest<Raider>(point);
+		expect("nearest enemy" + at, nearestRaider != nullptr && distanceSquared(point, nearestRaider->bounds()) == bruteNearest(raiders, point, nullptr));
+
+		//excluding the nearest object finds the next one, the way an object looks for its nearest neighbour
+		Crate* next = screen.nearest<Crate>(point, std::numeric_limits<float>::infinity(), nearestCrate);
+		expect("nearest with exclude" + at, next != nullptr && next != nearestCrate && distanceSquared(point, next->bounds()) == bruteNearest(crates, point, nearestCrate));
+
+		//nothing farther than maxDistance is returned
+		Crate* bounded = screen.nearest<Crate>(point, radius);
+		float boundedExpected = bruteNearest(crates, point, nullptr);
+		if (boundedExpected > radius * radius) { expect("nearest beyond maxDistance" + at, bounded == nullptr); }
+		else { expect("nearest within maxDistance" + at, bounded != nullptr && distanceSquared(point, bounded->bounds()) == boundedExpected); }
+	}
+
+	//GameObject matches every collision object
+	std::vector<GameObject*> everything;
+	screen.queryRect<GameObject>(sf::FloatRect(-1000.f, -1000.f, 5000.f, 5000.f), everything);
+	expect("queryRect for every object", everything.size() == crates.size());
+
+	std::cout << (checks - failures) << " of " << checks << " spatial query checks passed" << std::endl;
+	return (failures == 0) ? 0 : 1;
+}
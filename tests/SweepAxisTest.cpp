@@ -0,0 +1,123 @@
+//wall sliding cases for TileMap::sweepAxis against a small map built in memory
+//build it with MappedFile.cpp and link against SFML like the benchmarks, it needs no data files
+//usage: SweepAxisTest, prints each failed case and exits with 1 if any failed
+
+#include "../TileMap.h"
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	int failures = 0;
+	int checks = 0;
+
+	void expect(const std::string& name, float actual, float expected)
+	{
+		checks++;
+		if (std::fabs(actual - expected) <= 0.01f) { return; }
+		failures++;
+		std::cout << "FAILED " << name << ": expected " << expected << ", got " << actual << std::endl;
+	}
+
+	const float tile = 32.f;
+	const uint8_t obstacle = TileProperties::Obstacle;
+	const uint8_t outOfBounds = TileProperties::OutOfBounds;
+
+	//12x12 tiles of 32px, tile type 1 is an obstacle
+	//BinaryMap makes row 0 and column 0 out of bounds, and everything off the map is out of bounds too
+	//a wall fills column 6 from row 2 to row 9, and a single obstacle sits at column 2, row 8
+	bool buildMap(TileMap& map)
+	{
+		const uint32_t size = 12;
+		std::vector<int> tiles(size * size, 0);
+		for (uint32_t row = 2; row <= 9; row++) { tiles[6 + row * size] = 1; }
+		tiles[2 + 8 * size] = 1;
+		std::istringstream propertiesText("obstacle 1\n");
+		TileProperties properties;
+		if (!properties.loadFromStream(propertiesText)) { return false; }
+		return map.readFromMemory(BinaryMap::encode(size, size, 32, 32, tiles, properties));
+	}
+
+	//moves the box x then y the way Screen resolves terrain, returns where it ends up
+	sf::FloatRect move(const TileMap& map, sf::FloatRect box, float dx, float dy, uint8_t flags)
+	{
+		box.left += map.sweepAxis(box, dx, true, flags);
+		box.top += map.sweepAxis(box, dy, false, flags);
+		return box;
+	}
+}
+
+int main()
+{
+	TileMap map;
+	if (!buildMap(map))
+	{
+		std::cout << "FAILED to build the test map" << std::endl;
+		return 1;
+	}
+	const float wallLeft = 6 * tile;
+	const float wallRight = 7 * tile;
+
+	//a box moving right stops with its edge exactly on the wall, then cannot move further into it
+	sf::FloatRect box(100.f, 100.f, 20.f, 20.f);
+	expect("flush stop", map.sweepAxis(box, 200.f, true, obstacle), wallLeft - 120.f);
+	sf::FloatRect flush(wallLeft - 20.f, 100.f, 20.f, 20.f);
+	expect("flush stays put", map.sweepAxis(flush, 5.f, true, obstacle), 0.f);
+
+	//a box touching a wall is not inside it, so moving away is never blocked
+	expect("away from flush on the left", map.sweepAxis(flush, -10.f, true, obstacle), -10.f);
+	sf::FloatRect flushRight(wallRight, 100.f, 20.f, 20.f);
+	expect("away from flush on the right", map.sweepAxis(flushRight, 10.f, true, obstacle), 10.f);
+	expect("into flush on the right", map.sweepAxis(flushRight, -10.f, true, obstacle), 0.f);
+
+	//a move far longer than the wall is thick still stops at the wall
+	expect("no tunnelling right", map.sweepAxis(box, 1000.f, true, obstacle), wallLeft - 120.f);
+	sf::FloatRect beyond(300.f, 100.f, 20.f, 20.f);
+	expect("no tunnelling left", map.sweepAxis(beyond, -1000.f, true, obstacle), wallRight - 300.f);
+
+	//pressing into the wall while moving down slides along it
+	sf::FloatRect slid = move(map, flush, 8.f, 40.f, obstacle);
+	expect("slide keeps x", slid.left, flush.left);
+	expect("slide moves y", slid.top, flush.top + 40.f);
+	slid = move(map, flush, 8.f, -40.f, obstacle);
+	expect("slide up moves y", slid.top, flush.top - 40.f);
+
+	//a box two and a half tiles wide is stopped by one obstacle under its middle, which none of its corners cross
+	sf::FloatRect wide(40.f, 100.f, 80.f, 20.f);
+	expect("wide box down", map.sweepAxis(wide, 500.f, false, obstacle), 8 * tile - 120.f);
+	sf::FloatRect wideBelow(40.f, 300.f, 80.f, 20.f);
+	expect("wide box up", map.sweepAxis(wideBelow, -500.f, false, obstacle), 9 * tile - 300.f);
+
+	//a box that starts inside the wall can move out of it on either side, the cells it overlaps are ignored
+	sf::FloatRect stuck(wallLeft + 4.f, 100.f, 20.f, 20.f);
+	expect("out of a wall to the right", map.sweepAxis(stuck, 40.f, true, obstacle), 40.f);
+	expect("out of a wall to the left", map.sweepAxis(stuck, -40.f, true, obstacle), -40.f);
+	expect("along the inside of a wall", map.sweepAxis(stuck, 40.f, false, obstacle), 4 * tile - 120.f);
+
+	//negative deltas on both axes, against obstacles and against the out of bounds border
+	sf::FloatRect rightOfWall(wallRight + 6.f, 100.f, 20.f, 20.f);
+	expect("left into obstacle", map.sweepAxis(rightOfWall, -100.f, true, obstacle), -6.f);
+	sf::FloatRect belowObstacle(70.f, 9 * tile + 12.f, 20.f, 20.f);
+	expect("up into obstacle", map.sweepAxis(belowObstacle, -100.f, false, obstacle), -12.f);
+	sf::FloatRect nearBorder(40.f, 40.f, 20.f, 20.f);
+	expect("left into out of bounds", map.sweepAxis(nearBorder, -100.f, true, outOfBounds), -8.f);
+	expect("up into out of bounds", map.sweepAxis(nearBorder, -100.f, false, outOfBounds), -8.f);
+	expect("left into out of bounds as obstacle", map.sweepAxis(nearBorder, -100.f, true, obstacle), -8.f);
+	expect("up into out of bounds as obstacle", map.sweepAxis(nearBorder, -100.f, false, obstacle), -8.f);
+	//obstacles inside the map do not stop a sweep that only checks the border
+	expect("obstacle ignored by out of bounds sweep", map.sweepAxis(rightOfWall, -100.f, true, outOfBounds), -100.f);
+	//the far edges of the map are out of bounds too
+	sf::FloatRect farCorner(12 * tile - 30.f, 12 * tile - 30.f, 20.f, 20.f);
+	expect("right off the map", map.sweepAxis(farCorner, 100.f, true, outOfBounds), 10.f);
+	expect("down off the map", map.sweepAxis(farCorner, 100.f, false, outOfBounds), 10.f);
+
+	expect("zero delta", map.sweepAxis(box, 0.f, true, obstacle), 0.f);
+
+	std::cout << (checks - failures) << " of " << checks << " sweep checks passed" << std::endl;
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+//packs every asset in a directory into one archive the game memory maps at startup, see AssetArchive.h for the format
+//score files are written by the game and the output archive itself is skipped, rerun the packer whenever an asset changes
+//usage: AssetPacker [--exclude .ext ...] [data [data/assets.pak]]
+
+#include "../AssetArchive.h"
+#include "../MappedFile.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Engine;
+
+int main(int argc, char** argv)
+{
+	std::vector<std::string> excluded = { ".dat", ".pak" };
+	std::vector<std::string> paths;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--exclude" && i + 1 < argc) { excluded.push_back(argv[++i]); }
+		else { paths.push_back(arg); }
+	}
+	if (paths.size() > 2)
+	{
+		std::cerr << "usage: AssetPacker [--exclude .ext ...] [data [data/assets.pak]]" << std::endl;
+		return 1;
+	}
+	std::filesystem::path directory = (paths.size() > 0) ? paths[0] : "data";
+	std::filesystem::path output = (paths.size() > 1) ? std::filesystem::path(paths[1]) : directory / "assets.pak";
+
+	std::error_code error;
+	std::vector<std::pair<std::string, std::vector<uint8_t>>> files;
+	uint64_t looseBytes = 0;
+	for (auto const & item : std::filesystem::recursive_directory_iterator(directory, error))
+	{
+		if (!item.is_regular_file()) { continue; }
+		std::string extension = item.path().extension().string();
+		if (std::find(excluded.begin(), excluded.end(), extension) != excluded.end()) { continue; }
+		std::error_code notFound;
+		if (std::filesystem::equivalent(item.path(), output, notFound)) { continue; }
+		//names are what ResourceManager is asked for, relative to the directory with forward slashes
+		std::string name = item.path().lexically_relative(directory).generic_string();
+		std::vector<uint8_t> contents;
+		if (item.file_size() > 0)
+		{
+			MappedFile file;
+			if (!file.open(item.path().string()))
+			{
+				std::cerr << "could not read " << item.path().string() << std::endl;
+				return 1;
+			}
+			contents.assign(file.data(), file.data() + file.size());
+		}
+		looseBytes += contents.size();
+		files.push_back({ name, std::move(contents) });
+	}
+	if (error)
+	{
+		std::cerr << "could not list " << directory.string() << ": " << error.message() << std::endl;
+		return 1;
+	}
+
+	size_t count = files.size();
+	std::vector<uint8_t> image = AssetArchive::encode(std::move(files));
+	AssetArchive archive;
+	if (!archive.view(image.data(), image.size()))
+	{
+		std::cerr << "the archive failed to validate" << std::endl;
+		return 1;
+	}
+	std::ofstream fout(output.string().c_str(), std::ios::binary);
+	fout.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+	if (!fout)
+	{
+		std::cerr << "could not write " << output.string() << std::endl;
+		return 1;
+	}
+	std::cout << directory.string() << " -> " << output.string() << ": " << count << " files, "
+		<< looseBytes << " bytes of assets, " << image.size() << " bytes packed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,63 @@
+//converts text tile maps (data/map_*.txt) to the binary map format TileMap can use in place
+//tile obstacle and trap flags are baked in from the tile properties file, rerun the converter when it changes
+//usage: MapConverter [--properties data/tile_properties.txt] <input.txt> <output.bmap> [<input.txt> <output.bmap> ...]
+
+#include "../BinaryMap.h"
+#include "../MappedFile.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+int main(int argc, char** argv)
+{
+	std::string propertiesFile = "data/tile_properties.txt";
+	std::vector<std::string> files;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--properties" && i + 1 < argc) { propertiesFile = argv[++i]; }
+		else { files.push_back(arg); }
+	}
+	if (files.empty() || files.size() % 2 != 0)
+	{
+		std::cerr << "usage: MapConverter [--properties data/tile_properties.txt] <input.txt> <output.bmap> [<input.txt> <output.bmap> ...]" << std::endl;
+		return 1;
+	}
+	TileProperties properties;
+	if (!properties.loadFromFile(propertiesFile))
+	{
+		std::cerr << "could not read " << propertiesFile << std::endl;
+		return 1;
+	}
+	for (size_t i = 0; i < files.size(); i += 2)
+	{
+		const std::string& input = files[i];
+		const std::string& output = files[i + 1];
+		MappedFile file;
+		if (!file.open(input))
+		{
+			std::cerr << "could not open " << input << std::endl;
+			return 1;
+		}
+		std::vector<uint8_t> image = BinaryMap::encodeText(reinterpret_cast<const char*>(file.data()), file.size(), properties);
+		BinaryMap map;
+		if (!map.view(image.data(), image.size()))
+		{
+			std::cerr << input << " is not a valid text map" << std::endl;
+			return 1;
+		}
+		std::ofstream fout(output.c_str(), std::ios::binary);
+		fout.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+		if (!fout)
+		{
+			std::cerr << "could not write " << output << std::endl;
+			return 1;
+		}
+		std::cout << input << " -> " << output << ": " << map.width() << "x" << map.height() << " tiles, "
+			<< map.spawnCount() << " spawn positions, " << image.size() << " bytes" << std::endl;
+	}
+	return 0;
+}